@@ -11,10 +11,11 @@
 #include "base/base64url.h"
 #include "base/strings/string_util.h"
 #include "brave/browser/brave_browser_process_impl.h"
+#include "brave/browser/net/brave_static_url_rules.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
-#include "brave/common/shield_exceptions.h"
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_service.h"
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
@@ -22,7 +23,6 @@
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/grit/brave_generated_resources.h"
 #include "content/public/browser/browser_thread.h"
-#include "extensions/common/url_pattern.h"
 #include "ui/base/resource/resource_bundle.h"
 
 using content::ResourceType;
@@ -76,28 +76,18 @@ bool GetPolyfillForAdBlock(bool allow_brave_shields, bool allow_ads,
     return false;
   }
 
-  static URLPattern analytics(URLPattern::SCHEME_ALL,
-      kGoogleAnalyticsPattern);
-  static URLPattern tag_manager(URLPattern::SCHEME_ALL,
-      kGoogleTagManagerPattern);
-  static URLPattern tag_services(URLPattern::SCHEME_ALL,
-      kGoogleTagServicesPattern);
-  if (analytics.MatchesURL(gurl)) {
-    std::string&& data_url = GetGoogleAnalyticsPolyfillJS();
-    *new_url_spec = data_url;
-    return true;
-  }
-
-  if (tag_manager.MatchesURL(gurl)) {
-    std::string&& data_url = GetGoogleTagManagerPolyfillJS();
-    *new_url_spec = data_url;
-    return true;
-  }
-
-  if (tag_services.MatchesURL(gurl)) {
-    std::string&& data_url = GetGoogleTagServicesPolyfillJS();
-    *new_url_spec = data_url;
-    return true;
+  switch (MatchStaticURLRule(gurl, StaticURLRuleGroup::kAdBlockPolyfill)) {
+    case StaticURLRule::kGoogleAnalytics:
+      *new_url_spec = GetGoogleAnalyticsPolyfillJS();
+      return true;
+    case StaticURLRule::kGoogleTagManager:
+      *new_url_spec = GetGoogleTagManagerPolyfillJS();
+      return true;
+    case StaticURLRule::kGoogleTagServices:
+      *new_url_spec = GetGoogleTagServicesPolyfillJS();
+      return true;
+    default:
+      break;
   }
 
   return false;
@@ -114,24 +104,42 @@ void OnBeforeURLRequestAdBlockTP(
   }
   DCHECK_NE(ctx->request_identifier, 0UL);
 
-  bool did_match_exception = false;
-  std::string tab_host = ctx->tab_origin.host();
-  if (!g_brave_browser_process->ad_block_service()->ShouldStartRequest(
-          ctx->request_url, ctx->resource_type, tab_host,
-          &did_match_exception, &ctx->cancel_request_explicitly)) {
-    ctx->blocked_by = kAdBlocked;
-  } else if (!did_match_exception &&
-             !g_brave_browser_process->ad_block_regional_service_manager()
-                  ->ShouldStartRequest(ctx->request_url, ctx->resource_type,
-                                       tab_host, &did_match_exception,
-                                       &ctx->cancel_request_explicitly)) {
-    ctx->blocked_by = kAdBlocked;
-  } else if (!did_match_exception &&
-             !g_brave_browser_process->ad_block_custom_filters_service()
-                  ->ShouldStartRequest(ctx->request_url, ctx->resource_type,
-                                       tab_host, &did_match_exception,
-                                       &ctx->cancel_request_explicitly)) {
+  // Resources that a page requests over and over skip the engines.
+  brave_shields::AdBlockDecisionCache* decision_cache =
+      brave_shields::AdBlockDecisionCache::GetInstance();
+  brave_shields::AdBlockDecisionCache::Decision decision;
+  const std::string tab_host = ctx->tab_origin.host();
+  if (!decision_cache->Get(ctx->request_url, ctx->resource_type, tab_host,
+                           &decision)) {
+    decision.should_block = false;
+    decision.cancel_request_explicitly = false;
+    // Every engine is queried with the same parameters, so serialize the
+    // request once instead of once per engine.
+    const brave_shields::AdBlockMatchContext match_context(
+        ctx->request_url, ctx->resource_type, tab_host, ctx->IsThirdParty());
+    bool did_match_exception = false;
+    if (!g_brave_browser_process->ad_block_service()->ShouldStartRequest(
+            match_context, &did_match_exception,
+            &decision.cancel_request_explicitly)) {
+      decision.should_block = true;
+    } else if (!did_match_exception &&
+               !g_brave_browser_process->ad_block_regional_service_manager()
+                    ->ShouldStartRequest(match_context, &did_match_exception,
+                                         &decision.cancel_request_explicitly)) {
+      decision.should_block = true;
+    } else if (!did_match_exception &&
+               !g_brave_browser_process->ad_block_custom_filters_service()
+                    ->ShouldStartRequest(match_context, &did_match_exception,
+                                         &decision.cancel_request_explicitly)) {
+      decision.should_block = true;
+    }
+    decision_cache->Put(ctx->request_url, ctx->resource_type, tab_host,
+                        decision);
+  }
+
+  if (decision.should_block) {
     ctx->blocked_by = kAdBlocked;
+    ctx->cancel_request_explicitly = decision.cancel_request_explicitly;
   }
 
   if (ctx->blocked_by == kAdBlocked) {
@@ -11,8 +11,10 @@
 #include "base/task/post_task.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/pref_names.h"
+#include "brave/components/brave_referrals/browser/referral_headers_index.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
+#include "brave/components/brave_shields/browser/https_everywhere_service.h"
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 #include "brave/components/content_settings/core/browser/brave_cookie_settings.h"
 #include "chrome/browser/browser_process.h"
@@ -22,7 +24,6 @@
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
-#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "net/url_request/url_request.h"
 
 using content::BrowserThread;
@@ -82,9 +83,8 @@ void RemoveTrackableSecurityHeadersForThirdParty(
     return;
   }
 
-  if (net::registry_controlled_domains::SameDomainOrHost(
-          request_url, top_frame_origin,
-          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES)) {
+  if (brave_shields::IsSameDomainOrHost(request_url.host_piece(),
+                                        top_frame_origin.host())) {
     return;
   }
 
@@ -100,7 +100,6 @@ void RemoveTrackableSecurityHeadersForThirdParty(
 BraveNetworkDelegateBase::BraveNetworkDelegateBase(
     extensions::EventRouterForwarder* event_router)
     : ChromeNetworkDelegate(event_router),
-      referral_headers_list_(nullptr),
       allow_google_auth_(true) {
   // Initialize the preference change registrar.
   base::PostTaskWithTraits(
@@ -145,7 +144,10 @@ void BraveNetworkDelegateBase::OnReferralHeadersChanged() {
 void BraveNetworkDelegateBase::SetReferralHeaders(
     base::ListValue* referral_headers) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
-  referral_headers_list_.reset(referral_headers);
+  // Compile the list once here rather than walking it for every request.
+  std::unique_ptr<base::ListValue> referral_headers_list(referral_headers);
+  referral_headers_index_ =
+      std::make_unique<brave::ReferralHeadersIndex>(*referral_headers_list);
 }
 
 int BraveNetworkDelegateBase::OnBeforeURLRequest(
@@ -156,10 +158,9 @@ int BraveNetworkDelegateBase::OnBeforeURLRequest(
     return ChromeNetworkDelegate::OnBeforeURLRequest(
         request, std::move(callback), new_url);
   }
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
-  brave::BraveRequestInfo::FillCTXFromRequest(request, ctx);
+  std::shared_ptr<brave::BraveRequestInfo> ctx =
+      GetRequestInfo(request, brave::kOnBeforeRequest);
   ctx->new_url = new_url;
-  ctx->event_type = brave::kOnBeforeRequest;
   callbacks_[request->identifier()] = std::move(callback);
   RunNextCallback(request, ctx);
   return net::ERR_IO_PENDING;
@@ -173,11 +174,10 @@ int BraveNetworkDelegateBase::OnBeforeStartTransaction(
     return ChromeNetworkDelegate::OnBeforeStartTransaction(
         request, std::move(callback), headers);
   }
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
-  brave::BraveRequestInfo::FillCTXFromRequest(request, ctx);
-  ctx->event_type = brave::kOnBeforeStartTransaction;
+  std::shared_ptr<brave::BraveRequestInfo> ctx =
+      GetRequestInfo(request, brave::kOnBeforeStartTransaction);
   ctx->headers = headers;
-  ctx->referral_headers_list = referral_headers_list_.get();
+  ctx->referral_headers_index = referral_headers_index_.get();
   callbacks_[request->identifier()] = std::move(callback);
   RunNextCallback(request, ctx);
   return net::ERR_IO_PENDING;
@@ -201,33 +201,40 @@ int BraveNetworkDelegateBase::OnHeadersReceived(
         override_response_headers, allowed_unsafe_redirect_url);
   }
 
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
-  callbacks_[request->identifier()] = std::move(callback);
-  brave::BraveRequestInfo::FillCTXFromRequest(request, ctx);
-  ctx->event_type = brave::kOnHeadersReceived;
+  std::shared_ptr<brave::BraveRequestInfo> ctx =
+      GetRequestInfo(request, brave::kOnHeadersReceived);
   ctx->original_response_headers = original_response_headers;
   ctx->override_response_headers = override_response_headers;
   ctx->allowed_unsafe_redirect_url = allowed_unsafe_redirect_url;
 
-  // Return ERR_IO_PENDING and run callbacks later by posting a task.
-  // URLRequestHttpJob::awaiting_callback_ will be set to true after we
-  // return net::ERR_IO_PENDING here, callbacks need to be run later than this
-  // to set awaiting_callback_ back to false.
-  base::PostTaskWithTraits(
-      FROM_HERE, {BrowserThread::IO},
+  // Run the callbacks inline and only return ERR_IO_PENDING when one of them
+  // defers. URLRequestHttpJob then waits with awaiting_callback_ set until
+  // |callback| runs: the deferring helper resumes the chain through
+  // RunNextCallback, which runs the remaining helpers and then |callback|.
+  const brave::ResponseCallback next_callback =
       base::Bind(&BraveNetworkDelegateBase::RunNextCallback,
-                 base::Unretained(this), request, ctx));
-  return net::ERR_IO_PENDING;
+                 base::Unretained(this), request, ctx);
+  int rv = RunHeadersReceivedCallbacks(ctx, next_callback);
+  if (rv == net::ERR_IO_PENDING) {
+    callbacks_[request->identifier()] = std::move(callback);
+    return net::ERR_IO_PENDING;
+  }
+  if (rv != net::OK) {
+    return rv;
+  }
+
+  return ChromeNetworkDelegate::OnHeadersReceived(
+      request, std::move(callback), ctx->original_response_headers,
+      ctx->override_response_headers, ctx->allowed_unsafe_redirect_url);
 }
 
 bool BraveNetworkDelegateBase::OnCanGetCookies(
     const URLRequest& request,
     const net::CookieList& cookie_list,
     bool allowed_from_caller) {
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
+  std::shared_ptr<brave::BraveRequestInfo> ctx =
+      GetRequestInfo(&request, brave::kOnCanGetCookies);
   ctx->allow_google_auth = allow_google_auth_;
-  brave::BraveRequestInfo::FillCTXFromRequest(&request, ctx);
-  ctx->event_type = brave::kOnCanGetCookies;
 
   return OnAllowAccessCookies(request, ctx);
 }
@@ -237,14 +244,32 @@ bool BraveNetworkDelegateBase::OnCanSetCookie(
     const net::CanonicalCookie& cookie,
     net::CookieOptions* options,
     bool allowed_from_caller) {
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
+  std::shared_ptr<brave::BraveRequestInfo> ctx =
+      GetRequestInfo(&request, brave::kOnCanSetCookies);
   ctx->allow_google_auth = allow_google_auth_;
-  brave::BraveRequestInfo::FillCTXFromRequest(&request, ctx);
-  ctx->event_type = brave::kOnCanSetCookies;
 
   return OnAllowAccessCookies(request, ctx);
 }
 
+std::shared_ptr<brave::BraveRequestInfo>
+BraveNetworkDelegateBase::GetRequestInfo(
+    const URLRequest* request,
+    brave::BraveNetworkDelegateEventType event_type) {
+  std::shared_ptr<brave::BraveRequestInfo>& ctx =
+      request_infos_[request->identifier()];
+  // A helper of an earlier event may still hold on to the old info, e.g.
+  // after the request was restarted, so only reuse it when nobody else does.
+  if (!ctx || ctx.use_count() > 1) {
+    ctx = std::make_shared<brave::BraveRequestInfo>();
+    brave::BraveRequestInfo::FillCTXFromRequest(request, ctx);
+  } else {
+    ctx->ResetEventState();
+    brave::BraveRequestInfo::UpdateCTXFromRequest(request, ctx);
+  }
+  ctx->event_type = event_type;
+  return ctx;
+}
+
 void BraveNetworkDelegateBase::RunCallbackForRequestIdentifier(
     uint64_t request_identifier,
     int rv) {
@@ -253,6 +278,22 @@ void BraveNetworkDelegateBase::RunCallbackForRequestIdentifier(
   std::move(it->second).Run(rv);
 }
 
+int BraveNetworkDelegateBase::RunHeadersReceivedCallbacks(
+    std::shared_ptr<brave::BraveRequestInfo> ctx,
+    const brave::ResponseCallback& next_callback) {
+  while (headers_received_callbacks_.size() != ctx->next_url_request_index) {
+    const brave::OnHeadersReceivedCallback& callback =
+        headers_received_callbacks_[ctx->next_url_request_index++];
+    int rv = callback.Run(ctx->original_response_headers,
+                          ctx->override_response_headers,
+                          ctx->allowed_unsafe_redirect_url, next_callback, ctx);
+    if (rv != net::OK) {
+      return rv;
+    }
+  }
+  return net::OK;
+}
+
 void BraveNetworkDelegateBase::RunNextCallback(
     URLRequest* request,
     std::shared_ptr<brave::BraveRequestInfo> ctx) {
@@ -266,17 +307,19 @@ void BraveNetworkDelegateBase::RunNextCallback(
     return;
   }
 
-  // Continue processing callbacks until we hit one that returns PENDING
+  // Continue processing callbacks until we hit one that returns PENDING.
+  // Every helper in the chain resumes it the same way, so the closure is
+  // only bound once.
   int rv = net::OK;
+  const brave::ResponseCallback next_callback =
+      base::Bind(&BraveNetworkDelegateBase::RunNextCallback,
+                 base::Unretained(this), request, ctx);
 
   if (ctx->event_type == brave::kOnBeforeRequest) {
     while (before_url_request_callbacks_.size() !=
            ctx->next_url_request_index) {
-      brave::OnBeforeURLRequestCallback callback =
+      const brave::OnBeforeURLRequestCallback& callback =
           before_url_request_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::Bind(&BraveNetworkDelegateBase::RunNextCallback,
-                     base::Unretained(this), request, ctx);
       rv = callback.Run(next_callback, ctx);
       if (rv == net::ERR_IO_PENDING) {
         return;
@@ -288,11 +331,8 @@ void BraveNetworkDelegateBase::RunNextCallback(
   } else if (ctx->event_type == brave::kOnBeforeStartTransaction) {
     while (before_start_transaction_callbacks_.size() !=
            ctx->next_url_request_index) {
-      brave::OnBeforeStartTransactionCallback callback =
+      const brave::OnBeforeStartTransactionCallback& callback =
           before_start_transaction_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::Bind(&BraveNetworkDelegateBase::RunNextCallback,
-                     base::Unretained(this), request, ctx);
       rv = callback.Run(ctx->headers, next_callback, ctx);
       if (rv == net::ERR_IO_PENDING) {
         return;
@@ -302,21 +342,9 @@ void BraveNetworkDelegateBase::RunNextCallback(
       }
     }
   } else if (ctx->event_type == brave::kOnHeadersReceived) {
-    while (headers_received_callbacks_.size() != ctx->next_url_request_index) {
-      brave::OnHeadersReceivedCallback callback =
-          headers_received_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::Bind(&BraveNetworkDelegateBase::RunNextCallback,
-                     base::Unretained(this), request, ctx);
-      rv = callback.Run(ctx->original_response_headers,
-                        ctx->override_response_headers,
-                        ctx->allowed_unsafe_redirect_url, next_callback, ctx);
-      if (rv == net::ERR_IO_PENDING) {
-        return;
-      }
-      if (rv != net::OK) {
-        break;
-      }
+    rv = RunHeadersReceivedCallbacks(ctx, next_callback);
+    if (rv == net::ERR_IO_PENDING) {
+      return;
     }
   }
 
@@ -370,6 +398,9 @@ void BraveNetworkDelegateBase::OnURLRequestDestroyed(URLRequest* request) {
   if (ContainsKey(callbacks_, request->identifier())) {
     callbacks_.erase(request->identifier());
   }
+  request_infos_.erase(request->identifier());
+  g_brave_browser_process->https_everywhere_service()->OnRequestDestroyed(
+      request->identifier());
   ChromeNetworkDelegate::OnURLRequestDestroyed(request);
 }
 
@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "base/containers/flat_set.h"
@@ -79,6 +80,17 @@ class BraveNetworkDelegateBase : public ChromeNetworkDelegate {
  protected:
   void RunNextCallback(net::URLRequest* request,
                        std::shared_ptr<brave::BraveRequestInfo> ctx);
+  // Runs the OnHeadersReceived helpers from ctx->next_url_request_index on.
+  // Returns net::OK once all of them ran, or the first other result, which
+  // is net::ERR_IO_PENDING when a helper resumes the chain later itself.
+  int RunHeadersReceivedCallbacks(
+      std::shared_ptr<brave::BraveRequestInfo> ctx,
+      const brave::ResponseCallback& next_callback);
+  // Returns the BraveRequestInfo of |request|, filled for |event_type|. It is
+  // created on the first event and reused until the request is destroyed.
+  std::shared_ptr<brave::BraveRequestInfo> GetRequestInfo(
+      const net::URLRequest* request,
+      brave::BraveNetworkDelegateEventType event_type);
   void set_allow_google_auth(bool allow);
   const base::FilePath& profile_path() { return profile_path_; }
 
@@ -97,8 +109,10 @@ class BraveNetworkDelegateBase : public ChromeNetworkDelegate {
   // rewards service. Eliminating this will also help to avoid using
   // PrefChangeRegistrar and corresponding |base::Unretained| usages, that are
   // illegal.
-  std::unique_ptr<base::ListValue> referral_headers_list_;
+  std::unique_ptr<brave::ReferralHeadersIndex> referral_headers_index_;
   std::map<uint64_t, net::CompletionOnceCallback> callbacks_;
+  std::unordered_map<uint64_t, std::shared_ptr<brave::BraveRequestInfo>>
+      request_infos_;
   std::unique_ptr<PrefChangeRegistrar, content::BrowserThread::DeleteOnUIThread>
       pref_change_registrar_;
 
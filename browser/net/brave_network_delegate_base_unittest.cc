@@ -5,6 +5,7 @@
 
 #include "brave/browser/net/brave_network_delegate_base.h"
 
+#include <memory>
 #include <string>
 
 #include "brave/browser/net/url_context.h"
@@ -44,6 +45,7 @@ class BraveNetworkDelegateBaseTest : public testing::Test {
         context_(new net::TestURLRequestContext(true)) {}
   ~BraveNetworkDelegateBaseTest() override {}
   void SetUp() override { context_->Init(); }
+  net::TestURLRequestContext* context() { return context_.get(); }
 
  private:
   content::TestBrowserThreadBundle thread_bundle_;
@@ -104,4 +106,64 @@ TEST_F(BraveNetworkDelegateBaseTest, RetainTrackableSecurityHeaders) {
   EXPECT_TRUE(headers->HasHeader(kXSSProtectionHeader));
 }
 
+TEST_F(BraveNetworkDelegateBaseTest, ReuseRequestInfoAcrossEvents) {
+  net::TestDelegate test_delegate;
+  std::unique_ptr<net::URLRequest> request = context()->CreateRequest(
+      GURL(kThirdPartyDomain), net::IDLE, &test_delegate,
+      TRAFFIC_ANNOTATION_FOR_TESTS);
+  auto ctx = std::make_shared<brave::BraveRequestInfo>();
+  brave::BraveRequestInfo::FillCTXFromRequest(request.get(), ctx);
+  ctx->event_type = brave::kOnBeforeRequest;
+  ctx->new_url_spec = kFirstPartyDomain;
+  ctx->next_url_request_index = 3;
+  ctx->blocked_by = brave::kAdBlocked;
+  ctx->cancel_request_explicitly = true;
+  ctx->allow_google_auth = false;
+
+  // The next event reuses the same info, without what the helpers of the
+  // previous event left behind.
+  ctx->ResetEventState();
+  brave::BraveRequestInfo::UpdateCTXFromRequest(request.get(), ctx);
+  EXPECT_EQ(ctx->request_url, GURL(kThirdPartyDomain));
+  EXPECT_EQ(ctx->request_identifier, request->identifier());
+  EXPECT_EQ(ctx->event_type, brave::kUnknownEventType);
+  EXPECT_TRUE(ctx->new_url_spec.empty());
+  EXPECT_EQ(ctx->next_url_request_index, 0u);
+  EXPECT_EQ(ctx->blocked_by, brave::kNotBlocked);
+  EXPECT_FALSE(ctx->cancel_request_explicitly);
+  EXPECT_TRUE(ctx->allow_google_auth);
+  EXPECT_EQ(ctx->headers, nullptr);
+}
+
+TEST_F(BraveNetworkDelegateBaseTest, UpdateRequestInfoOnlyWhereChanged) {
+  net::TestDelegate test_delegate;
+  std::unique_ptr<net::URLRequest> request = context()->CreateRequest(
+      GURL(kThirdPartyDomain), net::IDLE, &test_delegate,
+      TRAFFIC_ANNOTATION_FOR_TESTS);
+  request->set_site_for_cookies(GURL(kFirstPartyDomain));
+  auto ctx = std::make_shared<brave::BraveRequestInfo>();
+  brave::BraveRequestInfo::FillCTXFromRequest(request.get(), ctx);
+  EXPECT_EQ(ctx->tab_origin, GURL(kFirstPartyDomain));
+  EXPECT_TRUE(ctx->IsThirdParty());
+
+  // What is fixed for the life of a request is not read again, and neither
+  // are the shields settings while the tab URL stays the same.
+  ctx->upload_data = "filled once";
+  ctx->resource_type = content::ResourceType::kImage;
+  const bool allow_referrers = ctx->allow_referrers;
+  ctx->allow_referrers = !allow_referrers;
+  brave::BraveRequestInfo::UpdateCTXFromRequest(request.get(), ctx);
+  EXPECT_EQ(ctx->upload_data, "filled once");
+  EXPECT_EQ(ctx->resource_type, content::ResourceType::kImage);
+  EXPECT_EQ(ctx->allow_referrers, !allow_referrers);
+  EXPECT_TRUE(ctx->IsThirdParty());
+
+  // A new tab URL is picked up, and the request is no longer third-party.
+  request->set_site_for_cookies(GURL(kThirdPartyDomain));
+  brave::BraveRequestInfo::UpdateCTXFromRequest(request.get(), ctx);
+  EXPECT_EQ(ctx->tab_origin, GURL(kThirdPartyDomain));
+  EXPECT_FALSE(ctx->IsThirdParty());
+  EXPECT_EQ(ctx->upload_data, "filled once");
+}
+
 }  // namespace
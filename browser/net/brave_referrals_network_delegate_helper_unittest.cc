@@ -11,6 +11,7 @@
 #include "base/json/json_reader.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
+#include "brave/components/brave_referrals/browser/referral_headers_index.h"
 #include "chrome/test/base/chrome_render_view_host_test_harness.h"
 #include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
 #include "net/url_request/url_request_test_util.h"
@@ -89,7 +90,8 @@ TEST_F(BraveReferralsNetworkDelegateHelperTest,
       new brave::BraveRequestInfo());
   brave::BraveRequestInfo::FillCTXFromRequest(request.get(),
                                               brave_request_info);
-  brave_request_info->referral_headers_list = referral_headers_list;
+  brave::ReferralHeadersIndex referral_headers_index(*referral_headers_list);
+  brave_request_info->referral_headers_index = &referral_headers_index;
   int ret = brave::OnBeforeStartTransaction_ReferralsWork(
       &headers, callback, brave_request_info);
 
@@ -123,7 +125,8 @@ TEST_F(BraveReferralsNetworkDelegateHelperTest,
   brave::ResponseCallback callback;
   std::shared_ptr<brave::BraveRequestInfo> brave_request_info(
       new brave::BraveRequestInfo());
-  brave_request_info->referral_headers_list = referral_headers_list;
+  brave::ReferralHeadersIndex referral_headers_index(*referral_headers_list);
+  brave_request_info->referral_headers_index = &referral_headers_index;
   int ret = brave::OnBeforeStartTransaction_ReferralsWork(
       &headers, callback, brave_request_info);
 
@@ -132,4 +135,30 @@ TEST_F(BraveReferralsNetworkDelegateHelperTest,
   EXPECT_EQ(ret, net::OK);
 }
 
+TEST_F(BraveReferralsNetworkDelegateHelperTest, ReferralHeadersIndexMatching) {
+  base::Optional<base::Value> referral_headers = base::JSONReader().ReadToValue(
+      R"([{"domains": ["example.com"], "headers": {"X-Brave-Partner": "a"}},
+          {"domains": ["sub.example.com", "brave.com"],
+           "headers": {"X-Brave-Partner": "b"}},
+          {"domains": ["missing-headers.com"]}])");
+  ASSERT_TRUE(referral_headers);
+  base::ListValue* referral_headers_list = nullptr;
+  ASSERT_TRUE(referral_headers->GetAsList(&referral_headers_list));
+  brave::ReferralHeadersIndex index(*referral_headers_list);
+
+  const brave::ReferralHeadersIndex::Headers* headers =
+      index.GetMatchingHeaders(GURL("https://a.sub.example.com/path"));
+  ASSERT_TRUE(headers);
+  ASSERT_EQ(headers->size(), 1u);
+  EXPECT_EQ((*headers)[0].second, "a");
+
+  headers = index.GetMatchingHeaders(GURL("http://brave.com/"));
+  ASSERT_TRUE(headers);
+  EXPECT_EQ((*headers)[0].second, "b");
+
+  EXPECT_FALSE(index.GetMatchingHeaders(GURL("https://notexample.com/")));
+  EXPECT_FALSE(index.GetMatchingHeaders(GURL("ftp://example.com/")));
+  EXPECT_FALSE(index.GetMatchingHeaders(GURL("https://missing-headers.com/")));
+}
+
 }  // namespace
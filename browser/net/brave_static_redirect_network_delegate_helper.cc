@@ -8,6 +8,7 @@
 #include <memory>
 #include <vector>
 
+#include "brave/browser/net/brave_static_url_rules.h"
 #include "brave/browser/translate/buildflags/buildflags.h"
 #include "brave/common/network_constants.h"
 #include "brave/common/translate_network_constants.h"
@@ -31,92 +32,50 @@ int OnBeforeURLRequest_StaticRedirectWorkForGURL(
     const GURL& request_url,
     GURL* new_url) {
   GURL::Replacements replacements;
-  static URLPattern geo_pattern(URLPattern::SCHEME_HTTPS, kGeoLocationsPattern);
-  static URLPattern safeBrowsing_pattern(URLPattern::SCHEME_HTTPS,
-                                         kSafeBrowsingPrefix);
-  static URLPattern safebrowsingfilecheck_pattern(URLPattern::SCHEME_HTTPS,
-                                         kSafeBrowsingFileCheckPrefix);
-  static URLPattern crlSet_pattern1(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix1);
-  static URLPattern crlSet_pattern2(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix2);
-  static URLPattern crlSet_pattern3(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix3);
-  static URLPattern crlSet_pattern4(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix4);
-  static URLPattern crxDownload_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRXDownloadPrefix);
-#if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
-  static URLPattern translate_pattern(URLPattern::SCHEME_HTTPS,
-      kTranslateElementJSPattern);
-  static URLPattern translate_language_pattern(URLPattern::SCHEME_HTTPS,
-      kTranslateLanguagePattern);
-#endif
-  if (geo_pattern.MatchesURL(request_url)) {
-    *new_url = GURL(GOOGLEAPIS_ENDPOINT GOOGLEAPIS_API_KEY);
-    return net::OK;
-  }
-
-  if (safeBrowsing_pattern.MatchesHost(request_url)) {
-    replacements.SetHostStr(SAFEBROWSING_ENDPOINT);
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
+  switch (MatchStaticURLRule(request_url,
+                             StaticURLRuleGroup::kStaticRedirect)) {
+    case StaticURLRule::kGeoLocation:
+      *new_url = GURL(GOOGLEAPIS_ENDPOINT GOOGLEAPIS_API_KEY);
+      return net::OK;
+
+    case StaticURLRule::kSafeBrowsing:
+      replacements.SetHostStr(SAFEBROWSING_ENDPOINT);
+      *new_url = request_url.ReplaceComponents(replacements);
+      return net::OK;
+
+    case StaticURLRule::kSafeBrowsingFileCheck:
+      replacements.SetHostStr(kBraveSafeBrowsingFileCheckProxy);
+      *new_url = request_url.ReplaceComponents(replacements);
+      return net::OK;
+
+    case StaticURLRule::kCRXDownload:
+      replacements.SetSchemeStr("https");
+      replacements.SetHostStr("crxdownload.brave.com");
+      *new_url = request_url.ReplaceComponents(replacements);
+      return net::OK;
+
+    case StaticURLRule::kCRLSet:
+      replacements.SetSchemeStr("https");
+      replacements.SetHostStr("crlsets.brave.com");
+      *new_url = request_url.ReplaceComponents(replacements);
+      return net::OK;
 
-  if (safebrowsingfilecheck_pattern.MatchesHost(request_url)) {
-    replacements.SetHostStr(kBraveSafeBrowsingFileCheckProxy);
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
-
-  if (crxDownload_pattern.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crxdownload.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
-
-  if (crlSet_pattern1.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crlsets.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
-
-  if (crlSet_pattern2.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crlsets.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
-
-  if (crlSet_pattern3.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crlsets.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
-
-  if (crlSet_pattern4.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crlsets.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
 #if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
-  if (translate_pattern.MatchesURL(request_url)) {
-    replacements.SetQueryStr(request_url.query_piece());
-    replacements.SetPathStr(request_url.path_piece());
-    *new_url =
-      GURL(kBraveTranslateEndpoint).ReplaceComponents(replacements);
-    return net::OK;
-  }
+    case StaticURLRule::kTranslateElementJS:
+      replacements.SetQueryStr(request_url.query_piece());
+      replacements.SetPathStr(request_url.path_piece());
+      *new_url =
+        GURL(kBraveTranslateEndpoint).ReplaceComponents(replacements);
+      return net::OK;
+
+    case StaticURLRule::kTranslateLanguage:
+      *new_url = GURL(kBraveTranslateLanguageEndpoint);
+      return net::OK;
+#endif
 
-  if (translate_language_pattern.MatchesURL(request_url)) {
-    *new_url = GURL(kBraveTranslateLanguageEndpoint);
-    return net::OK;
+    default:
+      break;
   }
-#endif
 
 #if !defined(NDEBUG)
   GURL gurl = request_url;
@@ -175,7 +134,7 @@ int OnBeforeURLRequest_StaticRedirectWorkForGURL(
   // allowed patterns
   bool is_url_allowed =
       std::any_of(allowed_patterns.begin(), allowed_patterns.end(),
-                  [&gurl](URLPattern pattern) {
+                  [&gurl](const URLPattern& pattern) {
                     if (pattern.MatchesURL(gurl)) {
                       return true;
                     }
@@ -0,0 +1,110 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_static_url_rules.h"
+
+#include "brave/browser/net/url_pattern_host_index.h"
+#include "brave/browser/translate/buildflags/buildflags.h"
+#include "brave/common/network_constants.h"
+#include "brave/common/translate_network_constants.h"
+#include "extensions/common/url_pattern.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+const int kHTTPAndHTTPS = URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS;
+
+struct StaticURLRuleEntry {
+  StaticURLRuleGroup group;
+  StaticURLRule rule;
+  int valid_schemes;
+  const char* pattern;
+  bool match_host_only;
+};
+
+// Within a group, rules are matched in the order they are listed here.
+const StaticURLRuleEntry kStaticURLRules[] = {
+    {StaticURLRuleGroup::kStaticRedirect, StaticURLRule::kGeoLocation,
+     URLPattern::SCHEME_HTTPS, kGeoLocationsPattern, false},
+    {StaticURLRuleGroup::kStaticRedirect, StaticURLRule::kSafeBrowsing,
+     URLPattern::SCHEME_HTTPS, kSafeBrowsingPrefix, true},
+    {StaticURLRuleGroup::kStaticRedirect,
+     StaticURLRule::kSafeBrowsingFileCheck, URLPattern::SCHEME_HTTPS,
+     kSafeBrowsingFileCheckPrefix, true},
+    {StaticURLRuleGroup::kStaticRedirect, StaticURLRule::kCRXDownload,
+     kHTTPAndHTTPS, kCRXDownloadPrefix, false},
+    {StaticURLRuleGroup::kStaticRedirect, StaticURLRule::kCRLSet,
+     kHTTPAndHTTPS, kCRLSetPrefix1, false},
+    {StaticURLRuleGroup::kStaticRedirect, StaticURLRule::kCRLSet,
+     kHTTPAndHTTPS, kCRLSetPrefix2, false},
+    {StaticURLRuleGroup::kStaticRedirect, StaticURLRule::kCRLSet,
+     kHTTPAndHTTPS, kCRLSetPrefix3, false},
+    {StaticURLRuleGroup::kStaticRedirect, StaticURLRule::kCRLSet,
+     kHTTPAndHTTPS, kCRLSetPrefix4, false},
+#if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
+    {StaticURLRuleGroup::kStaticRedirect, StaticURLRule::kTranslateElementJS,
+     URLPattern::SCHEME_HTTPS, kTranslateElementJSPattern, false},
+    {StaticURLRuleGroup::kStaticRedirect, StaticURLRule::kTranslateLanguage,
+     URLPattern::SCHEME_HTTPS, kTranslateLanguagePattern, false},
+#endif
+
+    {StaticURLRuleGroup::kAdBlockPolyfill, StaticURLRule::kGoogleAnalytics,
+     URLPattern::SCHEME_ALL, kGoogleAnalyticsPattern, false},
+    {StaticURLRuleGroup::kAdBlockPolyfill, StaticURLRule::kGoogleTagManager,
+     URLPattern::SCHEME_ALL, kGoogleTagManagerPattern, false},
+    {StaticURLRuleGroup::kAdBlockPolyfill, StaticURLRule::kGoogleTagServices,
+     URLPattern::SCHEME_ALL, kGoogleTagServicesPattern, false},
+
+    {StaticURLRuleGroup::kBlockedResource, StaticURLRule::kBlockedResource,
+     URLPattern::SCHEME_ALL, "https://pdfjs.robwu.nl/*", false},
+
+    {StaticURLRuleGroup::kUAWhitelist, StaticURLRule::kUAWhitelisted,
+     URLPattern::SCHEME_ALL, "https://*.adobe.com/*", false},
+    {StaticURLRuleGroup::kUAWhitelist, StaticURLRule::kUAWhitelisted,
+     URLPattern::SCHEME_ALL, "https://*.duckduckgo.com/*", false},
+    {StaticURLRuleGroup::kUAWhitelist, StaticURLRule::kUAWhitelisted,
+     URLPattern::SCHEME_ALL, "https://*.brave.com/*", false},
+    // For Widevine
+    {StaticURLRuleGroup::kUAWhitelist, StaticURLRule::kUAWhitelisted,
+     URLPattern::SCHEME_ALL, "https://*.netflix.com/*", false},
+};
+
+URLPatternHostIndex* CreateStaticURLRuleIndex() {
+  URLPatternHostIndex* index = new URLPatternHostIndex();
+  for (const auto& entry : kStaticURLRules) {
+    index->Add(static_cast<int>(entry.group), static_cast<int>(entry.rule),
+               URLPattern(entry.valid_schemes, entry.pattern),
+               entry.match_host_only);
+  }
+  return index;
+}
+
+const URLPatternHostIndex& GetStaticURLRuleIndex() {
+  static const URLPatternHostIndex* index = CreateStaticURLRuleIndex();
+  return *index;
+}
+
+}  // namespace
+
+StaticURLRule MatchStaticURLRule(const GURL& url, StaticURLRuleGroup group) {
+  int rule;
+  if (!GetStaticURLRuleIndex().Match(url, static_cast<int>(group), &rule))
+    return StaticURLRule::kNone;
+  return static_cast<StaticURLRule>(rule);
+}
+
+bool IsUAWhitelisted(const GURL& gurl) {
+  return MatchStaticURLRule(gurl, StaticURLRuleGroup::kUAWhitelist) !=
+         StaticURLRule::kNone;
+}
+
+bool IsBlockedResource(const GURL& gurl) {
+  return MatchStaticURLRule(gurl, StaticURLRuleGroup::kBlockedResource) !=
+         StaticURLRule::kNone;
+}
+
+}  // namespace brave
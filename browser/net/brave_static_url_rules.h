@@ -0,0 +1,51 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_BRAVE_STATIC_URL_RULES_H_
+#define BRAVE_BROWSER_NET_BRAVE_STATIC_URL_RULES_H_
+
+class GURL;
+
+namespace brave {
+
+// Hardcoded URL rules applied by the network delegate helpers. All of them
+// are served from a single host-indexed table.
+enum class StaticURLRuleGroup {
+  kStaticRedirect,
+  kAdBlockPolyfill,
+  kBlockedResource,
+  kUAWhitelist,
+};
+
+enum class StaticURLRule {
+  kNone,
+  // kStaticRedirect
+  kGeoLocation,
+  kSafeBrowsing,
+  kSafeBrowsingFileCheck,
+  kCRXDownload,
+  kCRLSet,
+  kTranslateElementJS,
+  kTranslateLanguage,
+  // kAdBlockPolyfill
+  kGoogleAnalytics,
+  kGoogleTagManager,
+  kGoogleTagServices,
+  // kBlockedResource
+  kBlockedResource,
+  // kUAWhitelist
+  kUAWhitelisted,
+};
+
+// Returns the first rule of |group| that matches |url|, or
+// StaticURLRule::kNone.
+StaticURLRule MatchStaticURLRule(const GURL& url, StaticURLRuleGroup group);
+
+bool IsUAWhitelisted(const GURL& gurl);
+bool IsBlockedResource(const GURL& gurl);
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_BRAVE_STATIC_URL_RULES_H_
@@ -84,17 +84,110 @@ BraveRequestInfo::BraveRequestInfo() = default;
 
 BraveRequestInfo::~BraveRequestInfo() = default;
 
+void BraveRequestInfo::ResetEventState() {
+  new_referrer = GURL();
+  new_url_spec.clear();
+  allow_google_auth = true;
+  next_url_request_index = 0;
+  headers = nullptr;
+  original_response_headers = nullptr;
+  override_response_headers = nullptr;
+  allowed_unsafe_redirect_url = nullptr;
+  event_type = kUnknownEventType;
+  referral_headers_index = nullptr;
+  blocked_by = kNotBlocked;
+  cancel_request_explicitly = false;
+  new_url = nullptr;
+}
+
+const std::string& BraveRequestInfo::GetRequestETLDPlusOne() {
+  if (!request_etld_plus_one) {
+    request_etld_plus_one =
+        brave_shields::GetETLDPlusOne(request_url.host_piece());
+  }
+  return *request_etld_plus_one;
+}
+
+const std::string& BraveRequestInfo::GetTabETLDPlusOne() {
+  if (!tab_etld_plus_one) {
+    tab_etld_plus_one = brave_shields::GetETLDPlusOne(tab_origin.host_piece());
+  }
+  return *tab_etld_plus_one;
+}
+
+bool BraveRequestInfo::IsThirdParty() {
+  if (!is_third_party) {
+    // Mirrors brave_shields::IsSameDomainOrHost(), reusing the domains
+    // computed above.
+    const base::StringPiece request_host = request_url.host_piece();
+    const base::StringPiece tab_host = tab_origin.host_piece();
+    bool same_domain_or_host = false;
+    if (!request_host.empty() && !tab_host.empty()) {
+      same_domain_or_host =
+          request_host == tab_host ||
+          (!GetRequestETLDPlusOne().empty() &&
+           GetRequestETLDPlusOne() == GetTabETLDPlusOne());
+    }
+    is_third_party = !same_domain_or_host;
+  }
+  return *is_third_party;
+}
+
+void BraveRequestInfo::SetRequestURL(const GURL& url) {
+  if (request_url == url)
+    return;
+  request_url = url;
+  request_etld_plus_one.reset();
+  is_third_party.reset();
+}
+
+void BraveRequestInfo::SetTabURL(const net::URLRequest* request,
+                                 const GURL& url) {
+  tab_url = url;
+  tab_origin = tab_url.GetOrigin();
+  tab_etld_plus_one.reset();
+  is_third_party.reset();
+  allow_brave_shields = brave_shields::IsAllowContentSettingFromIO(
+      request, tab_origin, tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
+      brave_shields::kBraveShields) &&
+    !request->site_for_cookies().SchemeIs(kChromeExtensionScheme);
+  allow_ads = brave_shields::IsAllowContentSettingFromIO(
+      request, tab_origin, tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
+      brave_shields::kAds);
+  allow_http_upgradable_resource =
+      brave_shields::IsAllowContentSettingFromIO(request, tab_origin,
+          tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
+      brave_shields::kHTTPUpgradableResources);
+  allow_referrers = brave_shields::IsAllowContentSettingFromIO(
+      request, tab_origin, tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
+      brave_shields::kReferrers);
+}
+
+// static
+GURL BraveRequestInfo::GetTabURLFromRequest(
+    const net::URLRequest* request,
+    std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  if (!request->site_for_cookies().is_empty())
+    return request->site_for_cookies();
+  // We can not always use site_for_cookies since it can be empty in certain
+  // cases. See the comments in url_request.h
+  GURL tab_url(request->network_isolation_key().ToString());
+  if (tab_url.is_empty()) {
+    tab_url = brave_shields::BraveShieldsWebContentsObserver::
+        GetTabURLFromRenderFrameInfo(ctx->render_process_id,
+                                     ctx->render_frame_id,
+                                     ctx->frame_tree_node_id).GetOrigin();
+  }
+  return tab_url;
+}
+
 void BraveRequestInfo::FillCTXFromRequest(const net::URLRequest* request,
     std::shared_ptr<brave::BraveRequestInfo> ctx) {
   ctx->request_identifier = request->identifier();
-  ctx->request_url = request->url();
   if (request->initiator().has_value()) {
     ctx->initiator_url = request->initiator()->GetURL();
   }
 
-  ctx->referrer = GURL(request->referrer());
-  ctx->referrer_policy = request->referrer_policy();
-
   auto* request_info = content::ResourceRequestInfo::ForRequest(request);
   if (request_info) {
     ctx->resource_type = request_info->GetResourceType();
@@ -107,36 +200,25 @@ void BraveRequestInfo::FillCTXFromRequest(const net::URLRequest* request,
                                     &ctx->render_frame_id,
                                     &ctx->render_process_id,
                                     &ctx->frame_tree_node_id);
-  if (!request->site_for_cookies().is_empty()) {
-    ctx->tab_url = request->site_for_cookies();
-  } else {
-    // We can not always use site_for_cookies since it can be empty in certain
-    // cases. See the comments in url_request.h
-    ctx->tab_url = GURL(request->network_isolation_key().ToString());
-    if (ctx->tab_url.is_empty()) {
-      ctx->tab_url = brave_shields::BraveShieldsWebContentsObserver::
-          GetTabURLFromRenderFrameInfo(ctx->render_process_id,
-                                       ctx->render_frame_id,
-                                       ctx->frame_tree_node_id).GetOrigin();
-    }
-  }
-  ctx->tab_origin = ctx->tab_url.GetOrigin();
-  ctx->allow_brave_shields = brave_shields::IsAllowContentSettingFromIO(
-      request, ctx->tab_origin, ctx->tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kBraveShields) &&
-    !request->site_for_cookies().SchemeIs(kChromeExtensionScheme);
-  ctx->allow_ads = brave_shields::IsAllowContentSettingFromIO(
-      request, ctx->tab_origin, ctx->tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kAds);
-  ctx->allow_http_upgradable_resource =
-      brave_shields::IsAllowContentSettingFromIO(request, ctx->tab_origin,
-          ctx->tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kHTTPUpgradableResources);
-  ctx->allow_referrers = brave_shields::IsAllowContentSettingFromIO(
-      request, ctx->tab_origin, ctx->tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kReferrers);
-
   ctx->upload_data = GetUploadDataFromURLRequest(request);
+
+  ctx->SetRequestURL(request->url());
+  ctx->referrer = GURL(request->referrer());
+  ctx->referrer_policy = request->referrer_policy();
+  ctx->SetTabURL(request, GetTabURLFromRequest(request, ctx));
+}
+
+void BraveRequestInfo::UpdateCTXFromRequest(const net::URLRequest* request,
+    std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  ctx->SetRequestURL(request->url());
+  if (ctx->referrer.possibly_invalid_spec() != request->referrer())
+    ctx->referrer = GURL(request->referrer());
+  ctx->referrer_policy = request->referrer_policy();
+  // The shields settings only need to be read again when a redirect of the
+  // main frame moved the request to another tab URL.
+  GURL tab_url = GetTabURLFromRequest(request, ctx);
+  if (tab_url != ctx->tab_url)
+    ctx->SetTabURL(request, tab_url);
 }
 
 }  // namespace brave
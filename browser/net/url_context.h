@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 
+#include "base/optional.h"
 #include "chrome/browser/net/chrome_network_delegate.h"
 #include "content/public/common/resource_type.h"
 #include "net/url_request/url_request.h"
@@ -18,6 +19,7 @@ class BraveNetworkDelegateBase;
 
 namespace brave {
 
+class ReferralHeadersIndex;
 struct BraveRequestInfo;
 using ResponseCallback = base::Callback<void()>;
 
@@ -75,7 +77,7 @@ struct BraveRequestInfo {
   scoped_refptr<net::HttpResponseHeaders>* override_response_headers = nullptr;
   GURL* allowed_unsafe_redirect_url = nullptr;
   BraveNetworkDelegateEventType event_type = kUnknownEventType;
-  const base::ListValue* referral_headers_list = nullptr;
+  const ReferralHeadersIndex* referral_headers_index = nullptr;
   BlockedBy blocked_by = kNotBlocked;
   bool cancel_request_explicitly = false;
   // Default to invalid type for resource_type, so delegate helpers
@@ -86,8 +88,27 @@ struct BraveRequestInfo {
 
   std::string upload_data;
 
+  // Fills every field from |request|, on the first event of a request.
   static void FillCTXFromRequest(const net::URLRequest* request,
                                  std::shared_ptr<brave::BraveRequestInfo> ctx);
+  // Refreshes only the fields that can change between the events of a
+  // request, such as the URLs after a redirect. The rest, like the frame
+  // info and the upload data, stays as FillCTXFromRequest left it.
+  static void UpdateCTXFromRequest(
+      const net::URLRequest* request,
+      std::shared_ptr<brave::BraveRequestInfo> ctx);
+
+  // The same BraveRequestInfo is reused for every network delegate event of
+  // a request. This clears what the previous event's helpers left behind.
+  void ResetEventState();
+
+  // The registrable domains (eTLD+1) of |request_url| and |tab_origin|, and
+  // whether the request is third-party to the tab. Each is computed the first
+  // time a helper asks for it and kept until one of the urls changes, so the
+  // public suffix list is consulted at most once per request.
+  const std::string& GetRequestETLDPlusOne();
+  const std::string& GetTabETLDPlusOne();
+  bool IsThirdParty();
 
  private:
   // Please don't add any more friends here if it can be avoided.
@@ -100,8 +121,18 @@ struct BraveRequestInfo {
       std::shared_ptr<brave::BraveRequestInfo> ctx);
   friend class ::BraveNetworkDelegateBase;
 
+  static GURL GetTabURLFromRequest(const net::URLRequest* request,
+                                   std::shared_ptr<BraveRequestInfo> ctx);
+  void SetRequestURL(const GURL& url);
+  // Also reads the shields settings of the new tab origin.
+  void SetTabURL(const net::URLRequest* request, const GURL& url);
+
   GURL* new_url = nullptr;
 
+  base::Optional<std::string> request_etld_plus_one;
+  base::Optional<std::string> tab_etld_plus_one;
+  base::Optional<bool> is_third_party;
+
   DISALLOW_COPY_AND_ASSIGN(BraveRequestInfo);
 };
 
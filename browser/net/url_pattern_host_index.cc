@@ -0,0 +1,83 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/url_pattern_host_index.h"
+
+#include <algorithm>
+
+#include "base/strings/string_piece.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+URLPatternHostIndex::Entry::Entry(int group,
+                                  int id,
+                                  const URLPattern& pattern,
+                                  bool match_host_only)
+    : group(group),
+      id(id),
+      pattern(pattern),
+      match_host_only(match_host_only) {}
+
+URLPatternHostIndex::Entry::Entry(const Entry& other) = default;
+
+URLPatternHostIndex::Entry::~Entry() = default;
+
+URLPatternHostIndex::URLPatternHostIndex() = default;
+
+URLPatternHostIndex::~URLPatternHostIndex() = default;
+
+void URLPatternHostIndex::Add(int group, int id, const URLPattern& pattern,
+                              bool match_host_only) {
+  const size_t position = entries_.size();
+  entries_.emplace_back(group, id, pattern, match_host_only);
+  if (pattern.match_all_urls() || pattern.host().empty()) {
+    any_host_entries_.push_back(position);
+  } else {
+    host_index_[pattern.host()].push_back(position);
+  }
+}
+
+bool URLPatternHostIndex::Match(const GURL& url, int group, int* id) const {
+  size_t first_match = FindFirstMatch(any_host_entries_, url, group);
+
+  // Patterns with subdomain wildcards are indexed under their base host, so
+  // look up the URL's host and each of its parent domains.
+  base::StringPiece host = url.host_piece();
+  while (!host.empty()) {
+    auto it = host_index_.find(host.as_string());
+    if (it != host_index_.end()) {
+      first_match =
+          std::min(first_match, FindFirstMatch(it->second, url, group));
+    }
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+
+  if (first_match == entries_.size())
+    return false;
+  *id = entries_[first_match].id;
+  return true;
+}
+
+size_t URLPatternHostIndex::FindFirstMatch(
+    const std::vector<size_t>& candidates,
+    const GURL& url,
+    int group) const {
+  for (size_t position : candidates) {
+    const Entry& entry = entries_[position];
+    if (entry.group != group)
+      continue;
+    if (entry.match_host_only ? entry.pattern.MatchesHost(url)
+                              : entry.pattern.MatchesURL(url)) {
+      return position;
+    }
+  }
+  return entries_.size();
+}
+
+}  // namespace brave
@@ -0,0 +1,68 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_URL_PATTERN_HOST_INDEX_H_
+#define BRAVE_BROWSER_NET_URL_PATTERN_HOST_INDEX_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace brave {
+
+// A fixed set of URLPatterns, indexed by the host they apply to. A lookup
+// only evaluates the patterns registered for the URL's host or one of its
+// parent domains (plus patterns that match every host), instead of walking
+// the whole set.
+//
+// Every pattern belongs to a |group| and carries an |id|. Match() returns the
+// id of the first pattern, in the order they were added, of the requested
+// group that matches.
+class URLPatternHostIndex {
+ public:
+  URLPatternHostIndex();
+  ~URLPatternHostIndex();
+
+  // Adds |pattern|. When |match_host_only| is true, only the host part of the
+  // pattern is compared with the URL, like URLPattern::MatchesHost().
+  void Add(int group, int id, const URLPattern& pattern,
+           bool match_host_only = false);
+
+  bool Match(const GURL& url, int group, int* id) const;
+
+ private:
+  struct Entry {
+    Entry(int group, int id, const URLPattern& pattern, bool match_host_only);
+    Entry(const Entry& other);
+    ~Entry();
+
+    int group;
+    int id;
+    URLPattern pattern;
+    bool match_host_only;
+  };
+
+  // Returns the position in |entries_| of the first entry of |candidates|
+  // that matches, or |entries_.size()| if none does.
+  size_t FindFirstMatch(const std::vector<size_t>& candidates,
+                        const GURL& url, int group) const;
+
+  std::vector<Entry> entries_;
+  // Positions in |entries_|, in increasing order, keyed by pattern host.
+  std::unordered_map<std::string, std::vector<size_t>> host_index_;
+  // Positions of the patterns that match any host.
+  std::vector<size_t> any_host_entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLPatternHostIndex);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_URL_PATTERN_HOST_INDEX_H_
@@ -0,0 +1,104 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/url_pattern_host_index.h"
+
+#include "brave/browser/net/brave_static_url_rules.h"
+#include "extensions/common/url_pattern.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+const int kGroup1 = 1;
+const int kGroup2 = 2;
+
+}  // namespace
+
+TEST(URLPatternHostIndexTest, MatchesExactAndSubdomainHosts) {
+  URLPatternHostIndex index;
+  index.Add(kGroup1, 1,
+            URLPattern(URLPattern::SCHEME_ALL, "https://www.example.com/a*"));
+  index.Add(kGroup1, 2,
+            URLPattern(URLPattern::SCHEME_ALL, "https://*.example.com/*"));
+
+  int id = 0;
+  ASSERT_TRUE(index.Match(GURL("https://www.example.com/abc"), kGroup1, &id));
+  EXPECT_EQ(1, id);
+  ASSERT_TRUE(index.Match(GURL("https://www.example.com/xyz"), kGroup1, &id));
+  EXPECT_EQ(2, id);
+  ASSERT_TRUE(index.Match(GURL("https://a.b.example.com/"), kGroup1, &id));
+  EXPECT_EQ(2, id);
+  ASSERT_TRUE(index.Match(GURL("https://example.com/"), kGroup1, &id));
+  EXPECT_EQ(2, id);
+  EXPECT_FALSE(index.Match(GURL("https://notexample.com/"), kGroup1, &id));
+  EXPECT_FALSE(index.Match(GURL("http://www.example.com/a"), kGroup1, &id));
+}
+
+TEST(URLPatternHostIndexTest, KeepsInsertionOrderAcrossBuckets) {
+  URLPatternHostIndex index;
+  index.Add(kGroup1, 1,
+            URLPattern(URLPattern::SCHEME_ALL, "https://*.example.com/*"));
+  index.Add(kGroup1, 2,
+            URLPattern(URLPattern::SCHEME_ALL, "https://www.example.com/*"));
+  index.Add(kGroup1, 3, URLPattern(URLPattern::SCHEME_ALL, "<all_urls>"));
+
+  int id = 0;
+  ASSERT_TRUE(index.Match(GURL("https://www.example.com/"), kGroup1, &id));
+  EXPECT_EQ(1, id);
+  ASSERT_TRUE(index.Match(GURL("https://brave.com/"), kGroup1, &id));
+  EXPECT_EQ(3, id);
+}
+
+TEST(URLPatternHostIndexTest, FiltersByGroup) {
+  URLPatternHostIndex index;
+  index.Add(kGroup1, 1,
+            URLPattern(URLPattern::SCHEME_ALL, "https://example.com/*"));
+  index.Add(kGroup2, 2,
+            URLPattern(URLPattern::SCHEME_ALL, "https://example.com/*"));
+
+  int id = 0;
+  ASSERT_TRUE(index.Match(GURL("https://example.com/"), kGroup2, &id));
+  EXPECT_EQ(2, id);
+  EXPECT_FALSE(index.Match(GURL("https://example.com/"), 3, &id));
+}
+
+TEST(URLPatternHostIndexTest, MatchHostOnly) {
+  URLPatternHostIndex index;
+  index.Add(kGroup1, 1,
+            URLPattern(URLPattern::SCHEME_HTTPS, "https://example.com/"),
+            true);
+
+  int id = 0;
+  EXPECT_TRUE(index.Match(GURL("https://example.com/some/path"), kGroup1,
+                          &id));
+  EXPECT_FALSE(index.Match(GURL("https://sub.example.com/"), kGroup1, &id));
+}
+
+TEST(URLPatternHostIndexTest, StaticURLRules) {
+  EXPECT_TRUE(IsUAWhitelisted(GURL("https://www.duckduckgo.com/")));
+  EXPECT_TRUE(IsUAWhitelisted(GURL("https://brave.com/")));
+  EXPECT_FALSE(IsUAWhitelisted(GURL("http://www.brave.com/")));
+  EXPECT_FALSE(IsUAWhitelisted(GURL("https://pdfjs.robwu.nl/ping")));
+  EXPECT_TRUE(IsBlockedResource(GURL("https://pdfjs.robwu.nl/ping")));
+  EXPECT_FALSE(IsBlockedResource(GURL("https://www.brave.com/")));
+  EXPECT_EQ(StaticURLRule::kCRLSet,
+            MatchStaticURLRule(
+                GURL("http://r2---sn-n4v7sn7y.gvt1.com/edgedl/release2/"
+                     "chrome_component/crl-set"),
+                StaticURLRuleGroup::kStaticRedirect));
+  EXPECT_EQ(StaticURLRule::kNone,
+            MatchStaticURLRule(
+                GURL("https://www.google-analytics.com/analytics.js"),
+                StaticURLRuleGroup::kStaticRedirect));
+  EXPECT_EQ(StaticURLRule::kGoogleAnalytics,
+            MatchStaticURLRule(
+                GURL("https://www.google-analytics.com/analytics.js"),
+                StaticURLRuleGroup::kAdBlockPolyfill));
+}
+
+}  // namespace brave
@@ -5,6 +5,10 @@
 
 #include "brave/browser/ui/webui/brave_adblock_ui.h"
 
+#include <string>
+
+#include "base/bind.h"
+#include "base/memory/weak_ptr.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/pref_names.h"
 #include "brave/common/webui_url_constants.h"
@@ -35,11 +39,14 @@ class AdblockDOMHandler : public content::WebUIMessageHandler {
   void HandleGetCustomFilters(const base::ListValue* args);
   void HandleGetRegionalLists(const base::ListValue* args);
   void HandleUpdateCustomFilters(const base::ListValue* args);
+  void OnGetCustomFilters(const std::string& custom_filters);
+
+  base::WeakPtrFactory<AdblockDOMHandler> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(AdblockDOMHandler);
 };
 
-AdblockDOMHandler::AdblockDOMHandler() {}
+AdblockDOMHandler::AdblockDOMHandler() : weak_factory_(this) {}
 
 AdblockDOMHandler::~AdblockDOMHandler() {}
 
@@ -76,9 +83,12 @@ void AdblockDOMHandler::HandleEnableFilterList(const base::ListValue* args) {
 
 void AdblockDOMHandler::HandleGetCustomFilters(const base::ListValue* args) {
   DCHECK_EQ(args->GetSize(), 0U);
-  const std::string custom_filters =
-      g_brave_browser_process->ad_block_custom_filters_service()
-          ->GetCustomFilters();
+  g_brave_browser_process->ad_block_custom_filters_service()->GetCustomFilters(
+      base::BindOnce(&AdblockDOMHandler::OnGetCustomFilters,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void AdblockDOMHandler::OnGetCustomFilters(const std::string& custom_filters) {
   if (!web_ui()->CanCallJavascript())
     return;
   web_ui()->CallJavascriptFunctionUnsafe("brave_adblock.onGetCustomFilters",
@@ -10,8 +10,6 @@ class GURL;
 
 namespace brave {
 
-bool IsUAWhitelisted(const GURL& gurl);
-bool IsBlockedResource(const GURL& gurl);
 bool IsWhitelistedCookieException(const GURL& firstPartyOrigin,
                                   const GURL& subresourceUrl,
                                   bool allow_google_auth);
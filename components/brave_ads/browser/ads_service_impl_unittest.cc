@@ -88,7 +88,6 @@ class MockRewardsService : public RewardsService {
       void(brave_rewards::GetAutoContributeCallback));
   MOCK_CONST_METHOD1(SetAutoContribute, void(bool));
   MOCK_CONST_METHOD0(UpdateAdsRewards, void());
-  MOCK_METHOD2(SetTimer, void(uint64_t, uint32_t*));
   MOCK_METHOD1(GetAllBalanceReports,
       void(const brave_rewards::GetAllBalanceReportsCallback&));
   MOCK_METHOD0(GetCurrentBalanceReport, void());
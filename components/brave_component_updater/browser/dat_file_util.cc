@@ -7,9 +7,10 @@
 
 #include <string>
 
-#include "base/logging.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
 
 namespace brave_component_updater {
 
@@ -44,4 +45,36 @@ std::string GetDATFileAsString(const base::FilePath& file_path) {
   return contents;
 }
 
+MappedDATFile::MappedDATFile() = default;
+
+MappedDATFile::~MappedDATFile() = default;
+
+// static
+std::unique_ptr<MappedDATFile> MappedDATFile::Create(
+    const base::FilePath& path) {
+  std::unique_ptr<MappedDATFile> dat_file(new MappedDATFile());
+  auto mapped_file = std::make_unique<base::MemoryMappedFile>();
+  if (mapped_file->Initialize(path) && mapped_file->length() > 0) {
+    dat_file->mapped_file_ = std::move(mapped_file);
+    return dat_file;
+  }
+
+  GetDATFileData(path, &dat_file->buffer_);
+  if (dat_file->buffer_.empty())
+    return nullptr;
+  return dat_file;
+}
+
+const unsigned char* MappedDATFile::data() const {
+  if (mapped_file_)
+    return mapped_file_->data();
+  return buffer_.data();
+}
+
+size_t MappedDATFile::size() const {
+  if (mapped_file_)
+    return mapped_file_->length();
+  return buffer_.size();
+}
+
 }  // namespace brave_component_updater
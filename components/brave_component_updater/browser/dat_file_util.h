@@ -12,6 +12,11 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/macros.h"
+
+namespace base {
+class MemoryMappedFile;
+}
 
 namespace brave_component_updater {
 
@@ -21,10 +26,37 @@ void GetDATFileData(const base::FilePath& file_path,
                     DATFileDataBuffer* buffer);
 std::string GetDATFileAsString(const base::FilePath& file_path);
 
+// The read-only contents of a DAT file. The file is memory-mapped, so its
+// bytes are backed by the page cache rather than a private heap copy. If
+// mapping fails the file is read into memory instead. Meant to be held only
+// while a client is deserialized from it: an open mapping keeps the file
+// locked on Windows, which stops the component updater from removing old
+// versions.
+class MappedDATFile {
+ public:
+  // Returns nullptr if the file is missing, empty or can't be read. Must be
+  // called where blocking is allowed.
+  static std::unique_ptr<MappedDATFile> Create(const base::FilePath& path);
+  ~MappedDATFile();
+
+  const unsigned char* data() const;
+  size_t size() const;
+
+ private:
+  MappedDATFile();
+
+  std::unique_ptr<base::MemoryMappedFile> mapped_file_;
+  DATFileDataBuffer buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedDATFile);
+};
+
 template<typename T>
 using LoadDATFileDataResult =
     std::pair<std::unique_ptr<T>, brave_component_updater::DATFileDataBuffer>;
 
+// For clients that may point into or write to the buffer they deserialize
+// from. The buffer is a private copy and must be kept alive with the client.
 template<typename T>
 LoadDATFileDataResult<T> LoadDATFileData(
     const base::FilePath& dat_file_path) {
@@ -41,6 +73,26 @@ LoadDATFileDataResult<T> LoadDATFileData(
       std::move(client), std::move(buffer));
 }
 
+// For clients whose deserialize(const char*, size_t) copies everything it
+// needs, such as adblock::Engine. The file is mapped only for the duration of
+// the call. Returns nullptr if the file can't be read or deserialized. Must be
+// called where blocking is allowed.
+template<typename T>
+std::unique_ptr<T> LoadMappedDATFileData(
+    const base::FilePath& dat_file_path) {
+  std::unique_ptr<MappedDATFile> dat_file =
+      MappedDATFile::Create(dat_file_path);
+  if (!dat_file)
+    return nullptr;
+
+  auto client = std::make_unique<T>();
+  if (!client->deserialize(reinterpret_cast<const char*>(dat_file->data()),
+                           dat_file->size()))
+    return nullptr;
+
+  return client;
+}
+
 
 }  // namespace brave_component_updater
 
@@ -0,0 +1,82 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_referrals/browser/referral_headers_index.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+ReferralHeadersIndex::ReferralHeadersIndex(
+    const base::ListValue& referral_headers_list) {
+  std::vector<size_t> domain_entries;
+  for (const auto& headers_value : referral_headers_list) {
+    const base::Value* domains_list =
+        headers_value.FindKeyOfType("domains", base::Value::Type::LIST);
+    if (!domains_list) {
+      LOG(WARNING) << "Failed to retrieve 'domains' key from referral headers";
+      continue;
+    }
+    const base::Value* headers_dict =
+        headers_value.FindKeyOfType("headers", base::Value::Type::DICTIONARY);
+    if (!headers_dict) {
+      LOG(WARNING) << "Failed to retrieve 'headers' key from referral headers";
+      continue;
+    }
+
+    Headers headers;
+    for (const auto& it : headers_dict->DictItems()) {
+      if (it.second.is_string())
+        headers.emplace_back(it.first, it.second.GetString());
+    }
+    for (const auto& domain_value : domains_list->GetList()) {
+      if (!domain_value.is_string() || domain_value.GetString().empty())
+        continue;
+      domains_.push_back(base::ToLowerASCII(domain_value.GetString()));
+      domain_entries.push_back(headers_.size());
+    }
+    headers_.push_back(std::move(headers));
+  }
+
+  // |domains_| is complete, so the StringPieces below stay valid.
+  std::vector<std::pair<base::StringPiece, size_t>> index;
+  for (size_t i = 0; i < domains_.size(); i++)
+    index.emplace_back(domains_[i], domain_entries[i]);
+  // flat_map keeps the first of equal keys, which is the earliest entry.
+  domain_index_ = base::flat_map<base::StringPiece, size_t>(std::move(index));
+}
+
+ReferralHeadersIndex::~ReferralHeadersIndex() = default;
+
+const ReferralHeadersIndex::Headers* ReferralHeadersIndex::GetMatchingHeaders(
+    const GURL& url) const {
+  if (!url.SchemeIsHTTPOrHTTPS())
+    return nullptr;
+
+  // A domain matches itself and all of its subdomains, so probe the host and
+  // each of its parent domains.
+  size_t match = headers_.size();
+  base::StringPiece host = url.host_piece();
+  while (!host.empty()) {
+    auto it = domain_index_.find(host);
+    if (it != domain_index_.end())
+      match = std::min(match, it->second);
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+
+  if (match == headers_.size())
+    return nullptr;
+  return &headers_[match];
+}
+
+}  // namespace brave
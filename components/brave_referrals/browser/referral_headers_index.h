@@ -0,0 +1,51 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_REFERRALS_BROWSER_REFERRAL_HEADERS_INDEX_H_
+#define BRAVE_COMPONENTS_BRAVE_REFERRALS_BROWSER_REFERRAL_HEADERS_INDEX_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+class GURL;
+
+namespace base {
+class ListValue;
+}
+
+namespace brave {
+
+// The referral headers list fetched from the referrals server, compiled into
+// a map from domain to the custom headers to send to that domain and its
+// subdomains. Looking up a request URL doesn't allocate.
+class ReferralHeadersIndex {
+ public:
+  using Headers = std::vector<std::pair<std::string, std::string>>;
+
+  explicit ReferralHeadersIndex(const base::ListValue& referral_headers_list);
+  ~ReferralHeadersIndex();
+
+  // Returns the headers for the first entry of the list that has a domain
+  // matching |url|, or nullptr if there is none.
+  const Headers* GetMatchingHeaders(const GURL& url) const;
+
+ private:
+  std::vector<Headers> headers_;
+  std::vector<std::string> domains_;
+  // Points into |domains_|, which isn't modified after construction. Maps
+  // each domain to the lowest index in |headers_| that lists it.
+  base::flat_map<base::StringPiece, size_t> domain_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReferralHeadersIndex);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMPONENTS_BRAVE_REFERRALS_BROWSER_REFERRAL_HEADERS_INDEX_H_
@@ -26,9 +26,31 @@ namespace brave_rewards {
 
 namespace {
 
-const int kCurrentVersionNumber = 6;
+const int kCurrentVersionNumber = 7;
 const int kCompatibleVersionNumber = 1;
 
+// Columns GetActivityList() may sort on. Order pairs name their column as SQL
+// text, so anything outside this list is dropped instead of being spliced
+// into the query.
+const char* const kActivityListOrderColumns[] = {
+  "ai.duration",
+  "ai.percent",
+  "ai.score",
+  "ai.visits",
+  "ai.weight",
+  "pi.name",
+};
+
+bool IsActivityListOrderColumn(const std::string& column) {
+  for (const char* order_column : kActivityListOrderColumns) {
+    if (column == order_column) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 }  // namespace
 
 PublisherInfoDatabase::PublisherInfoDatabase(const base::FilePath& db_path) :
@@ -419,7 +441,12 @@ bool PublisherInfoDatabase::CreateActivityInfoTable() {
       "    REFERENCES publisher_info (publisher_id)"
       "    ON DELETE CASCADE)");
 
-  return GetDB().Execute(sql.c_str());
+  if (!GetDB().Execute(sql.c_str())) {
+    return false;
+  }
+
+  // Older tables get these in MigrateV6toV7, once their columns are current
+  return CreateActivityInfoSortIndexes();
 }
 
 bool PublisherInfoDatabase::CreateActivityInfoIndex() {
@@ -430,6 +457,20 @@ bool PublisherInfoDatabase::CreateActivityInfoIndex() {
       "ON activity_info (publisher_id)");
 }
 
+bool PublisherInfoDatabase::CreateActivityInfoSortIndexes() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  // Lists are always read for one reconcile stamp, then either ordered by
+  // percent (the panel and the auto-contribute table) or filtered by visits
+  // and duration (the auto-contribute run).
+  return GetDB().Execute(
+      "CREATE INDEX IF NOT EXISTS activity_info_reconcile_stamp_percent_index "
+      "ON activity_info (reconcile_stamp, percent)") &&
+      GetDB().Execute(
+      "CREATE INDEX IF NOT EXISTS activity_info_reconcile_stamp_visits_index "
+      "ON activity_info (reconcile_stamp, visits, duration)");
+}
+
 bool PublisherInfoDatabase::InsertOrUpdateActivityInfo(
     const ledger::PublisherInfo& info) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -493,22 +534,52 @@ bool PublisherInfoDatabase::InsertOrUpdateActivityInfos(
   return transaction.Commit();
 }
 
-bool PublisherInfoDatabase::GetActivityList(
-    int start,
-    int limit,
-    ledger::ActivityInfoFilterPtr filter,
-    ledger::PublisherInfoList* list) {
+bool PublisherInfoDatabase::AddActivityVisits(
+    const ledger::ActivityVisitsList& list) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  CHECK(list);
-
   bool initialized = Init();
   DCHECK(initialized);
 
-  if (!initialized || filter.is_null()) {
+  if (!initialized) {
+    return false;
+  }
+
+  if (list.size() == 0) {
+    return true;
+  }
+
+  sql::Transaction transaction(&GetDB());
+  if (!transaction.Begin()) {
     return false;
   }
 
+  for (const auto& visits : list) {
+    sql::Statement activity_info_update(
+      GetDB().GetCachedStatement(SQL_FROM_HERE,
+          "UPDATE activity_info SET "
+          "visits = visits + ?, duration = duration + ?, score = score + ? "
+          "WHERE publisher_id = ? AND reconcile_stamp = ?"));
+
+    activity_info_update.BindInt(0, visits->visits);
+    activity_info_update.BindInt64(1, visits->duration);
+    activity_info_update.BindDouble(2, visits->score);
+    activity_info_update.BindString(3, visits->id);
+    activity_info_update.BindInt64(4, visits->reconcile_stamp);
+
+    if (!activity_info_update.Run()) {
+      transaction.Rollback();
+      return false;
+    }
+  }
+
+  return transaction.Commit();
+}
+
+// static
+std::string PublisherInfoDatabase::GetActivityListQuery(
+    const ledger::ActivityInfoFilter& filter,
+    int limit) {
   std::string query = "SELECT ai.publisher_id, ai.duration, ai.score, "
                       "ai.percent, ai.weight, pi.verified, pi.excluded, "
                       "pi.name, pi.url, pi.provider, "
@@ -518,55 +589,88 @@ bool PublisherInfoDatabase::GetActivityList(
                       "ON ai.publisher_id = pi.publisher_id "
                       "WHERE 1 = 1";
 
-  if (!filter->id.empty()) {
+  if (!filter.id.empty()) {
     query += " AND ai.publisher_id = ?";
   }
 
-  if (filter->reconcile_stamp > 0) {
+  if (filter.reconcile_stamp > 0) {
     query += " AND ai.reconcile_stamp = ?";
   }
 
-  if (filter->min_duration > 0) {
+  if (filter.min_duration > 0) {
     query += " AND ai.duration >= ?";
   }
 
-  if (filter->excluded != ledger::ExcludeFilter::FILTER_ALL &&
-      filter->excluded !=
+  if (filter.excluded != ledger::ExcludeFilter::FILTER_ALL &&
+      filter.excluded !=
         ledger::ExcludeFilter::FILTER_ALL_EXCEPT_EXCLUDED) {
     query += " AND pi.excluded = ?";
   }
 
-  if (filter->excluded ==
+  if (filter.excluded ==
     ledger::ExcludeFilter::FILTER_ALL_EXCEPT_EXCLUDED) {
     query += " AND pi.excluded != ?";
   }
 
-  if (filter->percent > 0) {
+  if (filter.percent > 0) {
     query += " AND ai.percent >= ?";
   }
 
-  if (filter->min_visits > 0) {
+  if (filter.min_visits > 0) {
     query += " AND ai.visits >= ?";
   }
 
-  if (!filter->non_verified) {
+  if (!filter.non_verified) {
     query += " AND pi.verified = 1";
   }
 
-  for (const auto& it : filter->order_by) {
-    query += " ORDER BY " + it->property_name;
-    query += (it->ascending ? " ASC" : " DESC");
+  std::string order_by;
+  for (const auto& it : filter.order_by) {
+    if (!IsActivityListOrderColumn(it->property_name)) {
+      LOG(ERROR) << "DB: Unknown activity order " << it->property_name;
+      continue;
+    }
+
+    order_by += order_by.empty() ? " ORDER BY " : ", ";
+    order_by += it->property_name;
+    order_by += (it->ascending ? " ASC" : " DESC");
+  }
+
+  if (!order_by.empty()) {
+    // Ties on the sort columns must come back in the same order every time,
+    // otherwise rows slip between pages
+    query += order_by + ", ai.publisher_id ASC";
   }
 
   if (limit > 0) {
-    query += " LIMIT " + std::to_string(limit);
+    query += " LIMIT ? OFFSET ?";
+  }
 
-    if (start > 1) {
-      query += " OFFSET " + std::to_string(start);
-    }
+  return query;
+}
+
+bool PublisherInfoDatabase::GetActivityList(
+    int start,
+    int limit,
+    ledger::ActivityInfoFilterPtr filter,
+    ledger::PublisherInfoList* list) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  CHECK(list);
+
+  bool initialized = Init();
+  DCHECK(initialized);
+
+  if (!initialized || filter.is_null()) {
+    return false;
   }
 
-  sql::Statement info_sql(db_.GetUniqueStatement(query.c_str()));
+  const std::string query = GetActivityListQuery(*filter, limit);
+
+  // Limits and offsets are bound, so a query shape is prepared only once
+  const char* query_id = activity_list_queries_.insert(query).first->c_str();
+  sql::Statement info_sql(GetDB().GetCachedStatement(
+      sql::StatementID(query_id), query_id));
 
   int column = 0;
   if (!filter->id.empty()) {
@@ -600,6 +704,11 @@ bool PublisherInfoDatabase::GetActivityList(
     info_sql.BindInt(column++, filter->min_visits);
   }
 
+  if (limit > 0) {
+    info_sql.BindInt(column++, limit);
+    info_sql.BindInt(column++, start > 1 ? start : 0);
+  }
+
   while (info_sql.Step()) {
     auto info = ledger::PublisherInfo::New();
     info->id = info_sql.ColumnString(0);
@@ -1412,6 +1521,20 @@ bool PublisherInfoDatabase::MigrateV5toV6() {
   return transaction.Commit();
 }
 
+bool PublisherInfoDatabase::MigrateV6toV7() {
+  sql::Transaction transaction(&GetDB());
+  if (!transaction.Begin()) {
+    return false;
+  }
+
+  if (!CreateActivityInfoSortIndexes()) {
+    LOG(ERROR) << "DB: Error with MigrateV6toV7";
+    return false;
+  }
+
+  return transaction.Commit();
+}
+
 bool PublisherInfoDatabase::Migrate(int version) {
   switch (version) {
     case 2: {
@@ -1429,6 +1552,9 @@ bool PublisherInfoDatabase::Migrate(int version) {
     case 6: {
       return MigrateV5toV6();
     }
+    case 7: {
+      return MigrateV6toV7();
+    }
     default:
       return false;
   }
@@ -7,6 +7,7 @@
 #define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_PUBLISHER_INFO_DATABASE_H_
 
 #include <memory>
+#include <set>
 #include <string>
 #include <stddef.h>  // NOLINT
 
@@ -58,11 +59,22 @@ class PublisherInfoDatabase {
 
   bool InsertOrUpdateActivityInfos(const ledger::PublisherInfoList& list);
 
+  // Adds the visits to the activity rows they were counted for. Nothing else
+  // in the rows, or in publisher_info, is changed, and visits without a row
+  // are dropped.
+  bool AddActivityVisits(const ledger::ActivityVisitsList& list);
+
   bool GetActivityList(int start,
                        int limit,
                        ledger::ActivityInfoFilterPtr filter,
                        ledger::PublisherInfoList* list);
 
+  // Returns the statement GetActivityList() prepares for |filter|, with
+  // placeholders for every value it binds.
+  static std::string GetActivityListQuery(
+      const ledger::ActivityInfoFilter& filter,
+      int limit);
+
   bool GetExcludedList(ledger::PublisherInfoList* list);
 
   bool InsertOrUpdateMediaPublisherInfo(const std::string& media_key,
@@ -124,6 +136,8 @@ class PublisherInfoDatabase {
 
   bool CreateActivityInfoIndex();
 
+  bool CreateActivityInfoSortIndexes();
+
   bool CreateMediaPublisherInfoTable();
 
   bool CreateRecurringTipsTable();
@@ -149,6 +163,8 @@ class PublisherInfoDatabase {
 
   bool MigrateV5toV6();
 
+  bool MigrateV6toV7();
+
   bool Migrate(int version);
 
   sql::InitStatus EnsureCurrentVersion();
@@ -159,6 +175,10 @@ class PublisherInfoDatabase {
   bool initialized_;
   int testing_current_version_;
 
+  // Every distinct GetActivityList() query built so far. The text doubles as
+  // the sql::StatementID of its cached statement, which keeps a pointer to it.
+  std::set<std::string> activity_list_queries_;
+
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
   SEQUENCE_CHECKER(sequence_checker_);
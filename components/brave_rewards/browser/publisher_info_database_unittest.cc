@@ -7,6 +7,7 @@
 #include <streambuf>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "brave/components/brave_rewards/browser/publisher_info_database.h"
 
@@ -95,6 +96,18 @@ class PublisherInfoDatabaseTest : public ::testing::Test {
     return static_cast<int>(s.ColumnInt64(0));
   }
 
+  std::string GetQueryPlan(const std::string& query) {
+    const std::string sql = "EXPLAIN QUERY PLAN " + query;
+    sql::Statement s(GetDB().GetUniqueStatement(sql.c_str()));
+
+    std::string plan;
+    while (s.Step()) {
+      plan += s.ColumnString(3) + "\n";
+    }
+
+    return plan;
+  }
+
   std::string GetSchemaString(int version) {
     const std::string file_name =
         "publisher_info_schema_v" +
@@ -703,6 +716,62 @@ TEST_F(PublisherInfoDatabaseTest, InsertOrUpdateActivityInfos) {
   EXPECT_FALSE(success);
 }
 
+TEST_F(PublisherInfoDatabaseTest, AddActivityVisits) {
+  base::ScopedTempDir temp_dir;
+  base::FilePath db_file;
+  CreateTempDatabase(&temp_dir, &db_file);
+
+  ledger::PublisherInfo info;
+  info.id = "brave.com";
+  info.url = "https://brave.com";
+  info.reconcile_stamp = 10;
+  info.visits = 5;
+  info.duration = 500;
+  info.score = 5.0;
+  EXPECT_TRUE(publisher_info_database_->InsertOrUpdateActivityInfo(info));
+
+  // Excluded after the visits were counted
+  info.excluded = ledger::PUBLISHER_EXCLUDE::EXCLUDED;
+  EXPECT_TRUE(publisher_info_database_->InsertOrUpdatePublisherInfo(info));
+
+  ledger::ActivityVisitsList list;
+  auto brave = ledger::ActivityVisits::New();
+  brave->id = "brave.com";
+  brave->reconcile_stamp = 10;
+  brave->visits = 2;
+  brave->duration = 20;
+  brave->score = 2.0;
+  list.push_back(std::move(brave));
+  auto unknown = ledger::ActivityVisits::New();
+  unknown->id = "unknown.com";
+  unknown->reconcile_stamp = 10;
+  unknown->visits = 1;
+  list.push_back(std::move(unknown));
+
+  EXPECT_TRUE(publisher_info_database_->AddActivityVisits(list));
+  EXPECT_TRUE(publisher_info_database_->AddActivityVisits(
+      ledger::ActivityVisitsList()));
+
+  std::string query =
+      "SELECT visits, duration, score FROM activity_info "
+      "WHERE publisher_id=? AND reconcile_stamp=?";
+  sql::Statement info_sql(GetDB().GetUniqueStatement(query.c_str()));
+  info_sql.BindString(0, "brave.com");
+  info_sql.BindInt64(1, 10);
+  EXPECT_TRUE(info_sql.Step());
+  EXPECT_EQ(info_sql.ColumnInt(0), 7);
+  EXPECT_EQ(info_sql.ColumnInt64(1), 520);
+  EXPECT_DOUBLE_EQ(info_sql.ColumnDouble(2), 7.0);
+
+  // Visits without a row are dropped, and publishers are left as they are
+  EXPECT_EQ(CountTableRows("activity_info"), 1);
+  EXPECT_EQ(CountTableRows("publisher_info"), 1);
+  ledger::PublisherInfoPtr publisher =
+      publisher_info_database_->GetPublisherInfo("brave.com");
+  ASSERT_TRUE(publisher);
+  EXPECT_EQ(publisher->excluded, ledger::PUBLISHER_EXCLUDE::EXCLUDED);
+}
+
 TEST_F(PublisherInfoDatabaseTest, InsertPendingContribution) {
   /**
    * Good path
@@ -1011,6 +1080,120 @@ TEST_F(PublisherInfoDatabaseTest, Migrationv4tov6) {
   EXPECT_EQ(publisher_info_database_->GetTableVersionNumber(), 6);
 }
 
+TEST_F(PublisherInfoDatabaseTest, Migrationv5tov7) {
+  base::ScopedTempDir temp_dir;
+  base::FilePath db_file;
+  CreateMigrationDatabase(&temp_dir, &db_file, 5, 7);
+
+  ledger::PublisherInfoList list;
+  auto filter = ledger::ActivityInfoFilter::New();
+  filter->excluded = ledger::ExcludeFilter::FILTER_ALL;
+  EXPECT_TRUE(publisher_info_database_->GetActivityList(0, 0,
+      std::move(filter), &list));
+  EXPECT_EQ(static_cast<int>(list.size()), 3);
+
+  EXPECT_EQ(publisher_info_database_->GetTableVersionNumber(), 7);
+
+  const std::string schema = publisher_info_database_->GetSchema();
+  EXPECT_EQ(schema, GetSchemaString(7));
+}
+
+TEST_F(PublisherInfoDatabaseTest, GetActivityListPaging) {
+  base::ScopedTempDir temp_dir;
+  base::FilePath db_file;
+  CreateTempDatabase(&temp_dir, &db_file);
+
+  const std::vector<uint32_t> percents = { 10, 30, 30, 20, 30 };
+  ledger::PublisherInfo info;
+  info.excluded = ledger::PUBLISHER_EXCLUDE::DEFAULT;
+  info.verified = true;
+  info.duration = 10;
+  info.visits = 1;
+  info.reconcile_stamp = 1;
+  for (size_t i = 0; i < percents.size(); i++) {
+    info.id = "publisher_" + std::to_string(i + 1);
+    info.name = "publisher_name_" + std::to_string(i + 1);
+    info.url = "https://publisher" + std::to_string(i + 1) + ".com";
+    info.percent = percents[i];
+    EXPECT_TRUE(publisher_info_database_->InsertOrUpdateActivityInfo(info));
+  }
+
+  auto create_filter = []() {
+    auto filter = ledger::ActivityInfoFilter::New();
+    filter->reconcile_stamp = 1;
+    filter->excluded = ledger::ExcludeFilter::FILTER_ALL_EXCEPT_EXCLUDED;
+    filter->percent = 1;
+    filter->order_by.push_back(
+        ledger::ActivityInfoFilterOrderPair::New("ai.percent", false));
+    return filter;
+  };
+
+  // Ties on percent are broken by publisher id, so pages never overlap
+  std::vector<std::string> ids;
+  for (int start = 0; start < 6; start += 2) {
+    ledger::PublisherInfoList page;
+    EXPECT_TRUE(publisher_info_database_->GetActivityList(start,
+                                                          2,
+                                                          create_filter(),
+                                                          &page));
+    for (const auto& item : page) {
+      ids.push_back(item->id);
+    }
+  }
+
+  const std::vector<std::string> expected = {
+    "publisher_2",
+    "publisher_3",
+    "publisher_5",
+    "publisher_4",
+    "publisher_1",
+  };
+  EXPECT_EQ(ids, expected);
+
+  // Unknown order columns are not spliced into the query
+  ledger::PublisherInfoList list;
+  auto filter = create_filter();
+  filter->order_by.clear();
+  filter->order_by.push_back(ledger::ActivityInfoFilterOrderPair::New(
+      "ai.percent; DROP TABLE activity_info", false));
+  EXPECT_TRUE(publisher_info_database_->GetActivityList(0,
+                                                        0,
+                                                        std::move(filter),
+                                                        &list));
+  EXPECT_EQ(static_cast<int>(list.size()), 5);
+  EXPECT_EQ(CountTableRows("activity_info"), 5);
+}
+
+TEST_F(PublisherInfoDatabaseTest, ActivityListQueryPlan) {
+  base::ScopedTempDir temp_dir;
+  base::FilePath db_file;
+  CreateTempDatabase(&temp_dir, &db_file);
+  EXPECT_TRUE(publisher_info_database_->Init());
+
+  // The queries are planned as they are prepared, before any value is bound
+  auto filter = ledger::ActivityInfoFilter::New();
+  filter->reconcile_stamp = 1;
+  filter->min_duration = 8;
+  filter->excluded = ledger::ExcludeFilter::FILTER_ALL_EXCEPT_EXCLUDED;
+  filter->min_visits = 1;
+  filter->non_verified = true;
+
+  // Auto-contribute run
+  EXPECT_THAT(GetQueryPlan(
+                  PublisherInfoDatabase::GetActivityListQuery(*filter, 0)),
+              testing::HasSubstr(
+                  "activity_info_reconcile_stamp_visits_index"));
+
+  // Panel and tips table
+  filter->percent = 1;
+  filter->order_by.push_back(
+      ledger::ActivityInfoFilterOrderPair::New("ai.percent", false));
+  EXPECT_THAT(GetQueryPlan(
+                  PublisherInfoDatabase::GetActivityListQuery(*filter, 20)),
+              testing::HasSubstr(
+                  "activity_info_reconcile_stamp_percent_index"));
+}
+
 TEST_F(PublisherInfoDatabaseTest, DeleteActivityInfo) {
   base::ScopedTempDir temp_dir;
   base::FilePath db_file;
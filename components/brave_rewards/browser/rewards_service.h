@@ -161,7 +161,6 @@ class RewardsService : public KeyedService {
       GetAutoContributeCallback callback) = 0;
   virtual void SetAutoContribute(bool enabled) const = 0;
   virtual void UpdateAdsRewards() const = 0;
-  virtual void SetTimer(uint64_t time_offset, uint32_t* timer_id) = 0;
   virtual void GetAllBalanceReports(
       const GetAllBalanceReportsCallback& callback) = 0;
   virtual void GetCurrentBalanceReport() = 0;
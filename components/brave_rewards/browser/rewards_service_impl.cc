@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/command_line.h"
 #include "base/containers/flat_map.h"
 #include "base/files/file_util.h"
@@ -25,6 +26,7 @@
 #include "base/sequenced_task_runner.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/run_loop.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/post_task.h"
 #include "base/task_runner_util.h"
@@ -66,6 +68,7 @@
 #include "content/public/browser/url_data_source.h"
 #include "content/public/common/service_manager_connection.h"
 #include "extensions/buildflags/buildflags.h"
+#include "mojo/public/cpp/bindings/callback_helpers.h"
 #include "mojo/public/cpp/bindings/map.h"
 #include "net/base/escape.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
@@ -97,6 +100,7 @@ using std::placeholders::_2;
 namespace brave_rewards {
 
 static const unsigned int kRetriesCountOnNetworkChange = 1;
+static const int64_t kShutdownVisitsTimeoutMs = 500;
 
 class LogStreamImpl : public ledger::LogStream {
  public:
@@ -251,6 +255,16 @@ bool SaveActivityInfoOnFileTaskRunner(
   return false;
 }
 
+bool AddActivityVisitsOnFileTaskRunner(
+    ledger::ActivityVisitsList list,
+    PublisherInfoDatabase* backend) {
+  if (backend &&
+      backend->AddActivityVisits(list))
+    return true;
+
+  return false;
+}
+
 ledger::PublisherInfoList GetActivityListOnFileTaskRunner(
     uint32_t start,
     uint32_t limit,
@@ -368,6 +382,12 @@ net::NetworkTrafficAnnotationTag GetNetworkTrafficAnnotationTagForURLLoad() {
 
 const char pref_prefix[] = "brave.rewards.";
 
+// Ledger and publisher state are rewritten in full after every change, often
+// several times in one contribution step; changes that land within this
+// interval share a single write.
+constexpr base::TimeDelta kStateWriteInterval =
+    base::TimeDelta::FromSeconds(1);
+
 }  // namespace
 
 bool IsMediaLink(const GURL& url,
@@ -409,14 +429,17 @@ RewardsServiceImpl::RewardsServiceImpl(Profile* profile)
       publisher_info_db_path_(profile->GetPath().Append(kPublisher_info_db)),
       publisher_list_path_(profile->GetPath().Append(kPublishers_list)),
       rewards_base_path_(profile_->GetPath().Append(kRewardsStatePath)),
+      ledger_state_writer_(std::make_unique<RewardsStateWriter>(
+          ledger_state_path_, file_task_runner_, kStateWriteInterval)),
+      publisher_state_writer_(std::make_unique<RewardsStateWriter>(
+          publisher_state_path_, file_task_runner_, kStateWriteInterval)),
       publisher_info_backend_(
           new PublisherInfoDatabase(publisher_info_db_path_)),
-      notification_service_(new RewardsNotificationServiceImpl(profile)),
+      notification_service_(new RewardsNotificationServiceImpl(profile)) {
 #if BUILDFLAG(ENABLE_EXTENSIONS)
-      private_observer_(
-          std::make_unique<ExtensionRewardsServiceObserver>(profile_)),
+  private_observer_ =
+      std::make_unique<ExtensionRewardsServiceObserver>(profile_);
 #endif
-      next_timer_id_(0) {
   file_task_runner_->PostTask(
       FROM_HERE, base::BindOnce(&EnsureRewardsBaseDirectoryExists,
                                 rewards_base_path_));
@@ -677,6 +700,13 @@ void RewardsServiceImpl::OnXHRLoad(SessionID tab_id,
   if (!Connected())
     return;
 
+  // Only a few media loads are of interest to the ledger, so skip parsing
+  // and sending everything else.
+  if (!ledger::Ledger::IsSupportedMediaLoad(url.spec(),
+                                            first_party_url.spec(),
+                                            referrer.spec()))
+    return;
+
   std::map<std::string, std::string> parts;
 
   for (net::QueryIterator it(url); !it.IsAtEnd(); it.Advance()) {
@@ -808,10 +838,46 @@ void RewardsServiceImpl::Shutdown() {
   }
   url_loaders_.clear();
 
+  ledger_state_writer_->Flush();
+  publisher_state_writer_->Flush();
+
+  // The ledger saves visits in batches. Whatever it hasn't saved yet comes
+  // back here, as its own writes would be lost with the connection. A slow
+  // or stuck utility process must not hold up shutdown, so the visits are
+  // only waited for briefly.
+  if (Connected()) {
+    base::RunLoop run_loop(base::RunLoop::Type::kNestableTasksAllowed);
+    bat_ledger_->TakeVisitsForShutdown(
+        mojo::WrapCallbackWithDefaultInvokeIfNotRun(
+            base::BindOnce(&RewardsServiceImpl::OnTakeVisitsForShutdown,
+                           AsWeakPtr(),
+                           run_loop.QuitClosure()),
+            ledger::ActivityVisitsList()));
+    base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+        FROM_HERE, run_loop.QuitClosure(),
+        base::TimeDelta::FromMilliseconds(kShutdownVisitsTimeoutMs));
+    run_loop.Run();
+  }
+
   bat_ledger_.reset();
   RewardsService::Shutdown();
 }
 
+void RewardsServiceImpl::OnTakeVisitsForShutdown(
+    base::OnceClosure quit_closure,
+    ledger::ActivityVisitsList visits) {
+  // Only the counters come back, so changes made to the rows since the
+  // visits were counted, e.g. an exclusion, are kept.
+  if (!visits.empty()) {
+    file_task_runner_->PostTask(FROM_HERE,
+        base::BindOnce(
+            base::IgnoreResult(&AddActivityVisitsOnFileTaskRunner),
+            std::move(visits),
+            publisher_info_backend_.get()));
+  }
+  std::move(quit_closure).Run();
+}
+
 void RewardsServiceImpl::OnWalletInitialized(ledger::Result result) {
   if (!ready_.is_signaled())
     ready_.Signal();
@@ -979,6 +1045,10 @@ void RewardsServiceImpl::OnReconcileComplete(ledger::Result result,
 
 void RewardsServiceImpl::LoadLedgerState(
     ledger::OnLoadCallback callback) {
+  // A ledger restarted after a crash may load within the write interval of
+  // its last save, so the pending state is written ahead of the read on the
+  // same sequence.
+  ledger_state_writer_->Flush();
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
       base::BindOnce(&LoadStateOnFileTaskRunner, ledger_state_path_),
       base::BindOnce(&RewardsServiceImpl::OnLedgerStateLoaded,
@@ -1008,6 +1078,7 @@ void RewardsServiceImpl::LoadPublisherState(
         base::BindOnce(&RewardsServiceImpl::SetRewardsMainEnabledPref,
           AsWeakPtr()));
   }
+  publisher_state_writer_->Flush();
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
       base::BindOnce(&LoadStateOnFileTaskRunner, publisher_state_path_),
       base::BindOnce(&RewardsServiceImpl::OnPublisherStateLoaded,
@@ -1029,18 +1100,9 @@ void RewardsServiceImpl::OnPublisherStateLoaded(
 
 void RewardsServiceImpl::SaveLedgerState(const std::string& ledger_state,
                                       ledger::LedgerCallbackHandler* handler) {
-  base::ImportantFileWriter writer(
-      ledger_state_path_, file_task_runner_);
-
-  writer.RegisterOnNextWriteCallbacks(
-      base::Closure(),
-      base::Bind(
-        &PostWriteCallback,
-        base::Bind(&RewardsServiceImpl::OnLedgerStateSaved, AsWeakPtr(),
-            base::Unretained(handler)),
-        base::SequencedTaskRunnerHandle::Get()));
-
-  writer.WriteNow(std::make_unique<std::string>(ledger_state));
+  ledger_state_writer_->Write(ledger_state,
+      base::Bind(&RewardsServiceImpl::OnLedgerStateSaved, AsWeakPtr(),
+          base::Unretained(handler)));
 }
 
 void RewardsServiceImpl::OnLedgerStateSaved(
@@ -1055,17 +1117,9 @@ void RewardsServiceImpl::OnLedgerStateSaved(
 
 void RewardsServiceImpl::SavePublisherState(const std::string& publisher_state,
                                       ledger::LedgerCallbackHandler* handler) {
-  base::ImportantFileWriter writer(publisher_state_path_, file_task_runner_);
-
-  writer.RegisterOnNextWriteCallbacks(
-      base::Closure(),
-      base::Bind(
-        &PostWriteCallback,
-        base::Bind(&RewardsServiceImpl::OnPublisherStateSaved, AsWeakPtr(),
-            base::Unretained(handler)),
-        base::SequencedTaskRunnerHandle::Get()));
-
-  writer.WriteNow(std::make_unique<std::string>(publisher_state));
+  publisher_state_writer_->Write(publisher_state,
+      base::Bind(&RewardsServiceImpl::OnPublisherStateSaved, AsWeakPtr(),
+          base::Unretained(handler)));
 }
 
 void RewardsServiceImpl::OnPublisherStateSaved(
@@ -1724,14 +1778,6 @@ void RewardsServiceImpl::ClearState(const std::string& name) {
   profile_->GetPrefs()->ClearPref(pref_prefix + name);
 }
 
-void RewardsServiceImpl::KillTimer(uint32_t timer_id) {
-  if (timers_.find(timer_id) == timers_.end())
-    return;
-
-  timers_[timer_id]->Stop();
-  timers_.erase(timer_id);
-}
-
 void RewardsServiceImpl::OnResetState(
   ledger::OnResetCallback callback, bool success) {
   if (!Connected())
@@ -1878,31 +1924,6 @@ void RewardsServiceImpl::OnPublishersListSaved(
                                          : ledger::Result::LEDGER_ERROR);
 }
 
-void RewardsServiceImpl::SetTimer(uint64_t time_offset,
-                                  uint32_t* timer_id) {
-  if (next_timer_id_ == std::numeric_limits<uint32_t>::max())
-    next_timer_id_ = 1;
-  else
-    ++next_timer_id_;
-
-  *timer_id = next_timer_id_;
-
-  timers_[next_timer_id_] = std::make_unique<base::OneShotTimer>();
-  timers_[next_timer_id_]->Start(FROM_HERE,
-      base::TimeDelta::FromSeconds(time_offset),
-      base::BindOnce(
-          &RewardsServiceImpl::OnTimer, AsWeakPtr(), next_timer_id_));
-}
-
-void RewardsServiceImpl::OnTimer(uint32_t timer_id) {
-  if (!Connected()) {
-    return;
-  }
-
-  timers_.erase(timer_id);
-  bat_ledger_->OnTimer(timer_id);
-}
-
 void RewardsServiceImpl::LoadPublisherList(
     ledger::LedgerCallbackHandler* handler) {
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
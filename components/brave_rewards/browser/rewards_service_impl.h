@@ -33,6 +33,7 @@
 #include "ui/gfx/image/image.h"
 #include "brave/components/brave_rewards/browser/publisher_banner.h"
 #include "brave/components/brave_rewards/browser/rewards_service_private_observer.h"
+#include "brave/components/brave_rewards/browser/rewards_state_writer.h"
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
 #include "brave/components/brave_rewards/browser/extension_rewards_service_observer.h"
@@ -333,7 +334,6 @@ class RewardsServiceImpl : public RewardsService,
                                  ledger::PublisherInfoList list);
   void OnPublishersListSaved(ledger::LedgerCallbackHandler* handler,
                              bool success);
-  void OnTimer(uint32_t timer_id);
   void OnPublisherListLoaded(ledger::LedgerCallbackHandler* handler,
                              const std::string& data);
   void OnSavedState(ledger::OnSaveCallback callback, bool success);
@@ -504,7 +504,6 @@ class RewardsServiceImpl : public RewardsService,
       ledger::PublisherInfoListCallback callback) override;
   void SavePublishersList(const std::string& publishers_list,
                           ledger::LedgerCallbackHandler* handler) override;
-  void SetTimer(uint64_t time_offset, uint32_t* timer_id) override;
   void LoadPublisherList(ledger::LedgerCallbackHandler* handler) override;
   void LoadURL(const std::string& url,
       const std::vector<std::string>& headers,
@@ -585,9 +584,6 @@ class RewardsServiceImpl : public RewardsService,
   uint64_t GetUint64State(const std::string& name) const override;
   void ClearState(const std::string& name) override;
 
-
-  void KillTimer(uint32_t timer_id) override;
-
   void RestorePublishers(ledger::RestorePublishersCallback callback) override;
 
   void OnPanelPublisherInfoLoaded(
@@ -660,6 +656,9 @@ class RewardsServiceImpl : public RewardsService,
       const std::string& publisher_key,
       const std::string& publisher_name) override;
 
+  void OnTakeVisitsForShutdown(base::OnceClosure quit_closure,
+                               ledger::ActivityVisitsList visits);
+
   bool Connected() const;
   void ConnectionClosed();
 
@@ -679,6 +678,8 @@ class RewardsServiceImpl : public RewardsService,
   const base::FilePath publisher_info_db_path_;
   const base::FilePath publisher_list_path_;
   const base::FilePath rewards_base_path_;
+  std::unique_ptr<RewardsStateWriter> ledger_state_writer_;
+  std::unique_ptr<RewardsStateWriter> publisher_state_writer_;
   std::unique_ptr<PublisherInfoDatabase> publisher_info_backend_;
   std::unique_ptr<RewardsNotificationServiceImpl> notification_service_;
   base::ObserverList<RewardsServicePrivateObserver> private_observers_;
@@ -688,14 +689,11 @@ class RewardsServiceImpl : public RewardsService,
 
   base::OneShotEvent ready_;
   base::flat_set<network::SimpleURLLoader*> url_loaders_;
-  std::map<uint32_t, std::unique_ptr<base::OneShotTimer>> timers_;
   std::vector<std::string> current_media_fetchers_;
   std::vector<BitmapFetcherService::RequestId> request_ids_;
   std::unique_ptr<base::OneShotTimer> notification_startup_timer_;
   std::unique_ptr<base::RepeatingTimer> notification_periodic_timer_;
 
-  uint32_t next_timer_id_;
-
   GetTestResponseCallback test_response_callback_;
 
   DISALLOW_COPY_AND_ASSIGN(RewardsServiceImpl);
@@ -0,0 +1,94 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/rewards_state_writer.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/sequenced_task_runner.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+namespace brave_rewards {
+
+namespace {
+
+// The write finishes on the file task runner; bounce the result back to the
+// sequence that owns the writer.
+void PostWriteCallback(
+    const base::Callback<void(bool success)>& callback,
+    scoped_refptr<base::SequencedTaskRunner> reply_task_runner,
+    bool write_success) {
+  reply_task_runner->PostTask(FROM_HERE,
+                              base::Bind(callback, write_success));
+}
+
+}  // namespace
+
+RewardsStateWriter::RewardsStateWriter(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    base::TimeDelta interval)
+    : writer_(path, std::move(task_runner), interval),
+      weak_factory_(this) {
+}
+
+RewardsStateWriter::~RewardsStateWriter() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // base::ImportantFileWriter must not be destroyed with a write pending.
+  // Callbacks of this last write are dropped along with |weak_factory_|.
+  Flush();
+}
+
+void RewardsStateWriter::Write(const std::string& data,
+                               const WriteCallback& callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  pending_data_ = data;
+  if (!callback.is_null())
+    pending_callbacks_.push_back(callback);
+  writer_.ScheduleWrite(this);
+}
+
+void RewardsStateWriter::Flush() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (writer_.HasPendingWrite())
+    writer_.DoScheduledWrite();
+}
+
+bool RewardsStateWriter::HasPendingWrite() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return writer_.HasPendingWrite();
+}
+
+bool RewardsStateWriter::SerializeData(std::string* data) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  data->swap(pending_data_);
+  pending_data_.clear();
+
+  // Registered here so that they are attached to the write that carries
+  // |data|, not to whichever write comes next.
+  std::vector<WriteCallback> callbacks;
+  callbacks.swap(pending_callbacks_);
+  writer_.RegisterOnNextWriteCallbacks(
+      base::Closure(),
+      base::Bind(
+          &PostWriteCallback,
+          base::Bind(&RewardsStateWriter::OnWriteDone,
+                     weak_factory_.GetWeakPtr(),
+                     callbacks),
+          base::SequencedTaskRunnerHandle::Get()));
+  return true;
+}
+
+void RewardsStateWriter::OnWriteDone(
+    const std::vector<WriteCallback>& callbacks,
+    bool success) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  for (const auto& callback : callbacks)
+    callback.Run(success);
+}
+
+}  // namespace brave_rewards
@@ -0,0 +1,65 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_REWARDS_STATE_WRITER_H_
+#define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_REWARDS_STATE_WRITER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/important_file_writer.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+
+namespace base {
+class FilePath;
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace brave_rewards {
+
+// Persists a state file that is rewritten in full on every change. Snapshots
+// handed to Write() within |interval| of each other are coalesced so that only
+// the latest one reaches the disk; the callbacks of all of them run with the
+// result of that single write.
+class RewardsStateWriter : public base::ImportantFileWriter::DataSerializer {
+ public:
+  using WriteCallback = base::Callback<void(bool success)>;
+
+  RewardsStateWriter(const base::FilePath& path,
+                     scoped_refptr<base::SequencedTaskRunner> task_runner,
+                     base::TimeDelta interval);
+  ~RewardsStateWriter() override;
+
+  void Write(const std::string& data, const WriteCallback& callback);
+
+  // Starts writing the pending snapshot, if any, without waiting for the
+  // rest of the interval.
+  void Flush();
+
+  bool HasPendingWrite() const;
+
+ private:
+  // base::ImportantFileWriter::DataSerializer:
+  bool SerializeData(std::string* data) override;
+
+  void OnWriteDone(const std::vector<WriteCallback>& callbacks, bool success);
+
+  base::ImportantFileWriter writer_;
+  std::string pending_data_;
+  std::vector<WriteCallback> pending_callbacks_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<RewardsStateWriter> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(RewardsStateWriter);
+};
+
+}  // namespace brave_rewards
+
+#endif  // BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_REWARDS_STATE_WRITER_H_
@@ -0,0 +1,121 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/rewards_state_writer.h"
+
+#include <memory>
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/task_runner_util.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=RewardsStateWriterTest.*
+
+namespace brave_rewards {
+
+namespace {
+
+void CountWrite(int* count, bool* all_succeeded, bool success) {
+  (*count)++;
+  *all_succeeded = *all_succeeded && success;
+}
+
+}  // namespace
+
+class RewardsStateWriterTest : public testing::Test {
+ public:
+  RewardsStateWriterTest()
+      : scoped_task_environment_(
+            base::test::ScopedTaskEnvironment::MainThreadType::MOCK_TIME) {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("ledger_state");
+    writer_ = std::make_unique<RewardsStateWriter>(
+        path_,
+        base::SequencedTaskRunnerHandle::Get(),
+        base::TimeDelta::FromSeconds(1));
+  }
+
+  std::string ReadState() {
+    std::string data;
+    base::ReadFileToString(path_, &data);
+    return data;
+  }
+
+ protected:
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+  std::unique_ptr<RewardsStateWriter> writer_;
+};
+
+TEST_F(RewardsStateWriterTest, CoalescesWritesWithinInterval) {
+  int count = 0;
+  bool all_succeeded = true;
+  for (int i = 0; i < 5; i++) {
+    writer_->Write("state " + std::to_string(i),
+        base::Bind(&CountWrite, &count, &all_succeeded));
+  }
+  EXPECT_TRUE(writer_->HasPendingWrite());
+  EXPECT_FALSE(base::PathExists(path_));
+
+  scoped_task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(1));
+  scoped_task_environment_.RunUntilIdle();
+
+  EXPECT_FALSE(writer_->HasPendingWrite());
+  EXPECT_EQ("state 4", ReadState());
+  EXPECT_EQ(5, count);
+  EXPECT_TRUE(all_succeeded);
+}
+
+TEST_F(RewardsStateWriterTest, FlushWritesImmediately) {
+  int count = 0;
+  bool all_succeeded = true;
+  writer_->Write("first", base::Bind(&CountWrite, &count, &all_succeeded));
+  writer_->Flush();
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ("first", ReadState());
+  EXPECT_EQ(1, count);
+
+  // A later write only carries its own callback.
+  writer_->Write("second", base::Bind(&CountWrite, &count, &all_succeeded));
+  writer_->Flush();
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ("second", ReadState());
+  EXPECT_EQ(2, count);
+  EXPECT_TRUE(all_succeeded);
+}
+
+TEST_F(RewardsStateWriterTest, ReadAfterFlushSeesPendingState) {
+  writer_->Write("saved", RewardsStateWriter::WriteCallback());
+  writer_->Flush();
+  // Loads are posted to the writer's sequence right after the flush, well
+  // within the write interval.
+  std::string loaded;
+  base::PostTaskAndReplyWithResult(
+      base::SequencedTaskRunnerHandle::Get().get(), FROM_HERE,
+      base::BindOnce(&RewardsStateWriterTest::ReadState,
+                     base::Unretained(this)),
+      base::BindOnce([](std::string* loaded, const std::string& data) {
+        *loaded = data;
+      }, &loaded));
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ("saved", loaded);
+}
+
+TEST_F(RewardsStateWriterTest, DestructionWritesPendingState) {
+  writer_->Write("pending", RewardsStateWriter::WriteCallback());
+  writer_.reset();
+  scoped_task_environment_.RunUntilIdle();
+  EXPECT_EQ("pending", ReadState());
+}
+
+}  // namespace brave_rewards
@@ -19,17 +19,16 @@
 #include "brave/browser/net/url_context.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/vendor/adblock_rust_ffi/src/wrapper.hpp"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
-#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
-#include "url/origin.h"
 
 using brave_component_updater::BraveComponent;
 using content::BrowserThread;
-using namespace net::registry_controlled_domains;  // NOLINT
 
 namespace {
 
@@ -103,6 +102,27 @@ std::string ResourceTypeToString(content::ResourceType resource_type) {
 
 namespace brave_shields {
 
+// Determine third-party here so the library doesn't need to figure it out.
+AdBlockMatchContext::AdBlockMatchContext(const GURL& url,
+                                         content::ResourceType resource_type,
+                                         const std::string& tab_host)
+    : AdBlockMatchContext(url,
+                          resource_type,
+                          tab_host,
+                          !IsSameDomainOrHost(url.host_piece(), tab_host)) {}
+
+AdBlockMatchContext::AdBlockMatchContext(const GURL& url,
+                                         content::ResourceType resource_type,
+                                         const std::string& tab_host,
+                                         bool is_third_party)
+    : url_spec(url.spec()),
+      url_host(url.host()),
+      tab_host(tab_host),
+      resource_type(ResourceTypeToString(resource_type)),
+      is_third_party(is_third_party) {}
+
+AdBlockMatchContext::~AdBlockMatchContext() {}
+
 AdBlockBaseService::AdBlockBaseService(BraveComponent::Delegate* delegate)
     : BaseBraveShieldsService(delegate),
       ad_block_client_(new adblock::Engine()),
@@ -124,19 +144,21 @@ bool AdBlockBaseService::ShouldStartRequest(const GURL& url,
     content::ResourceType resource_type, const std::string& tab_host,
     bool* did_match_exception, bool* cancel_request_explicitly) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  return ShouldStartRequest(AdBlockMatchContext(url, resource_type, tab_host),
+                            did_match_exception, cancel_request_explicitly);
+}
+
+bool AdBlockBaseService::ShouldStartRequest(
+    const AdBlockMatchContext& context,
+    bool* did_match_exception, bool* cancel_request_explicitly) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
 
-  // Determine third-party here so the library doesn't need to figure it out.
-  // CreateFromNormalizedTuple is needed because SameDomainOrHost needs
-  // a URL or origin and not a string to a host name.
-  bool is_third_party = !SameDomainOrHost(url,
-      url::Origin::CreateFromNormalizedTuple("https", tab_host.c_str(), 80),
-      INCLUDE_PRIVATE_REGISTRIES);
   bool explicit_cancel;
   bool saved_from_exception;
   // TODO(bbondy): Use redirect if it is provided.
   std::string redirect;
-  if (ad_block_client_->matches(url.spec(), url.host(),
-        tab_host, is_third_party, ResourceTypeToString(resource_type),
+  if (ad_block_client_->matches(context.url_spec, context.url_host,
+        context.tab_host, context.is_third_party, context.resource_type,
         &explicit_cancel, &saved_from_exception, &redirect)) {
     if (cancel_request_explicitly) {
       *cancel_request_explicitly = explicit_cancel;
@@ -146,9 +168,9 @@ bool AdBlockBaseService::ShouldStartRequest(const GURL& url,
       *did_match_exception = false;
     }
     // LOG(ERROR) << "AdBlockBaseService::ShouldStartRequest(), host: "
-    //  << tab_host
-    //  << ", resource type: " << resource_type
-    //  << ", url.spec(): " << url.spec();
+    //  << context.tab_host
+    //  << ", resource type: " << context.resource_type
+    //  << ", url.spec(): " << context.url_spec;
     return false;
   }
 
@@ -182,6 +204,7 @@ void AdBlockBaseService::EnableTagOnIOThread(
       tags_.erase(it);
     }
   }
+  AdBlockDecisionCache::GetInstance()->Invalidate();
 }
 
 bool AdBlockBaseService::TagExists(const std::string& tag) {
@@ -192,37 +215,37 @@ void AdBlockBaseService::GetDATFileData(const base::FilePath& dat_file_path) {
   base::PostTaskWithTraitsAndReplyWithResult(
       FROM_HERE, {base::MayBlock()},
       base::BindOnce(
-          &brave_component_updater::LoadDATFileData<adblock::Engine>,
+          &brave_component_updater::LoadMappedDATFileData<adblock::Engine>,
           dat_file_path),
       base::BindOnce(&AdBlockBaseService::OnGetDATFileData,
                      weak_factory_.GetWeakPtr()));
 }
 
-void AdBlockBaseService::OnGetDATFileData(GetDATFileDataResult result) {
-  if (result.second.empty()) {
-    LOG(ERROR) << "Could not obtain ad block data";
-    return;
-  }
-  if (!result.first.get()) {
-    LOG(ERROR) << "Failed to deserialize ad block data";
+void AdBlockBaseService::OnGetDATFileData(
+    std::unique_ptr<adblock::Engine> ad_block_client) {
+  if (!ad_block_client) {
+    LOG(ERROR) << "Could not load ad block data";
     return;
   }
 
+  SetAdBlockClient(std::move(ad_block_client));
+}
+
+void AdBlockBaseService::SetAdBlockClient(
+    std::unique_ptr<adblock::Engine> ad_block_client) {
   base::PostTaskWithTraits(
       FROM_HERE, {BrowserThread::IO},
       base::BindOnce(&AdBlockBaseService::UpdateAdBlockClient,
                      weak_factory_io_thread_.GetWeakPtr(),
-                     std::move(result.first),
-                     std::move(result.second)));
+                     std::move(ad_block_client)));
 }
 
 void AdBlockBaseService::UpdateAdBlockClient(
-    std::unique_ptr<adblock::Engine> ad_block_client,
-    brave_component_updater::DATFileDataBuffer buffer) {
+    std::unique_ptr<adblock::Engine> ad_block_client) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
   ad_block_client_ = std::move(ad_block_client);
-  buffer_ = std::move(buffer);
   AddKnownTagsToAdBlockInstance();
+  AdBlockDecisionCache::GetInstance()->Invalidate();
 }
 
 void AdBlockBaseService::AddKnownTagsToAdBlockInstance() {
@@ -243,6 +266,11 @@ void AdBlockBaseService::ResetForTest(const std::string& rules) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
   ad_block_client_.reset(new adblock::Engine(rules));
   AddKnownTagsToAdBlockInstance();
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::IO},
+      base::BindOnce([]() {
+        AdBlockDecisionCache::GetInstance()->Invalidate();
+      }));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
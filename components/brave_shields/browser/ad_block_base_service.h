@@ -14,11 +14,13 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
 #include "content/public/common/resource_type.h"
+#include "url/gurl.h"
 
 class AdBlockServiceTest;
 
@@ -29,19 +31,41 @@ class Engine;
 
 namespace brave_shields {
 
+// The request parameters handed to adblock::Engine::matches. They are the
+// same for the default, regional and custom filter engines, so they are
+// computed once per request and shared by every engine that is consulted.
+struct AdBlockMatchContext {
+  AdBlockMatchContext(const GURL& url,
+                      content::ResourceType resource_type,
+                      const std::string& tab_host);
+  // For callers that already know whether |url| is third-party to |tab_host|.
+  AdBlockMatchContext(const GURL& url,
+                      content::ResourceType resource_type,
+                      const std::string& tab_host,
+                      bool is_third_party);
+  ~AdBlockMatchContext();
+
+  std::string url_spec;
+  std::string url_host;
+  std::string tab_host;
+  std::string resource_type;
+  bool is_third_party;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockMatchContext);
+};
+
 // The base class of the brave shields service in charge of ad-block
 // checking and init.
 class AdBlockBaseService : public BaseBraveShieldsService {
  public:
-  using GetDATFileDataResult =
-      brave_component_updater::LoadDATFileDataResult<adblock::Engine>;
-
   explicit AdBlockBaseService(BraveComponent::Delegate* delegate);
   ~AdBlockBaseService() override;
 
   bool ShouldStartRequest(const GURL &url, content::ResourceType resource_type,
     const std::string& tab_host, bool* did_match_exception,
     bool* cancel_request_explicitly) override;
+  bool ShouldStartRequest(const AdBlockMatchContext& context,
+    bool* did_match_exception, bool* cancel_request_explicitly);
   void EnableTag(const std::string& tag, bool enabled);
   bool TagExists(const std::string& tag);
 
@@ -53,19 +77,21 @@ class AdBlockBaseService : public BaseBraveShieldsService {
   void GetDATFileData(const base::FilePath& dat_file_path);
   void AddKnownTagsToAdBlockInstance();
   void ResetForTest(const std::string& rules);
+  // Hands an engine that was built off the IO thread over to the IO thread,
+  // where it replaces |ad_block_client_|.
+  void SetAdBlockClient(std::unique_ptr<adblock::Engine> ad_block_client);
 
   SEQUENCE_CHECKER(sequence_checker_);
+  // Only read and replaced on the IO thread, so request matching never
+  // waits on list updates.
   std::unique_ptr<adblock::Engine> ad_block_client_;
 
  private:
-  void UpdateAdBlockClient(
-      std::unique_ptr<adblock::Engine> ad_block_client,
-      brave_component_updater::DATFileDataBuffer buffer);
-  void OnGetDATFileData(GetDATFileDataResult result);
+  void UpdateAdBlockClient(std::unique_ptr<adblock::Engine> ad_block_client);
+  void OnGetDATFileData(std::unique_ptr<adblock::Engine> ad_block_client);
   void EnableTagOnIOThread(const std::string& tag, bool enabled);
   void OnPreferenceChanges(const std::string& pref_name);
 
-  brave_component_updater::DATFileDataBuffer buffer_;
   std::vector<std::string> tags_;
   base::WeakPtrFactory<AdBlockBaseService> weak_factory_;
   base::WeakPtrFactory<AdBlockBaseService> weak_factory_io_thread_;
@@ -0,0 +1,37 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_base_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_shields::AdBlockMatchContext;
+
+TEST(AdBlockMatchContextTest, FirstPartyRequest) {
+  AdBlockMatchContext context(GURL("https://cdn.brave.com/script.js"),
+                              content::ResourceType::kScript,
+                              "www.brave.com");
+  EXPECT_EQ(context.url_spec, "https://cdn.brave.com/script.js");
+  EXPECT_EQ(context.url_host, "cdn.brave.com");
+  EXPECT_EQ(context.tab_host, "www.brave.com");
+  EXPECT_EQ(context.resource_type, "script");
+  EXPECT_FALSE(context.is_third_party);
+}
+
+TEST(AdBlockMatchContextTest, ThirdPartyRequest) {
+  AdBlockMatchContext context(GURL("https://ads.example.com/pixel.gif"),
+                              content::ResourceType::kImage,
+                              "www.brave.com");
+  EXPECT_EQ(context.url_host, "ads.example.com");
+  EXPECT_EQ(context.resource_type, "image");
+  EXPECT_TRUE(context.is_third_party);
+}
+
+TEST(AdBlockMatchContextTest, UnmappedResourceType) {
+  AdBlockMatchContext context(GURL("https://www.brave.com/sw.js"),
+                              content::ResourceType::kServiceWorker,
+                              "www.brave.com");
+  EXPECT_TRUE(context.resource_type.empty());
+  EXPECT_FALSE(context.is_third_party);
+}
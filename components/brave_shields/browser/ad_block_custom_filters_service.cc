@@ -5,35 +5,151 @@
 
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_service.h"
 
+#include <memory>
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
 #include "base/logging.h"
+#include "base/path_service.h"
+#include "base/strings/string_split.h"
+#include "base/task/post_task.h"
+#include "base/task_runner_util.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/vendor/adblock_rust_ffi/src/wrapper.hpp"
+#include "chrome/common/chrome_paths.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_thread.h"
 
+#define CUSTOM_FILTERS_FILE_NAME FILE_PATH_LITERAL("AdBlockCustomFilters.txt")
+// Lists larger than this are stored in the custom filters file.
+#define CUSTOM_FILTERS_MAX_PREF_SIZE (16 * 1024)
+
 using brave_component_updater::BraveComponent;
 
 namespace brave_shields {
 
+// The latest contents of the custom filters file that no write task has
+// picked up yet.
+struct AdBlockCustomFiltersService::PendingFileWrite
+    : public base::RefCountedThreadSafe<PendingFileWrite> {
+  PendingFileWrite() : generation(0) {}
+
+  base::Lock lock;
+  std::unique_ptr<std::string> contents;
+  int generation;
+
+ private:
+  friend class base::RefCountedThreadSafe<PendingFileWrite>;
+  ~PendingFileWrite() {}
+};
+
+namespace {
+
+base::FilePath GetCustomFiltersFilePath() {
+  base::FilePath user_data_dir;
+  base::PathService::Get(chrome::DIR_USER_DATA, &user_data_dir);
+  return user_data_dir.Append(CUSTOM_FILTERS_FILE_NAME);
+}
+
+std::string ReadCustomFiltersFile(const base::FilePath& path) {
+  std::string custom_filters;
+  if (base::PathExists(path) &&
+      !base::ReadFileToString(path, &custom_filters)) {
+    LOG(ERROR) << "Cannot read custom filters file " << path;
+  }
+  return custom_filters;
+}
+
+// The filter lines the engine would actually see: blank lines and comments
+// are dropped, and neither order nor duplicates change what gets blocked.
+std::set<std::string> GetFilterRules(const std::string& custom_filters) {
+  std::set<std::string> rules;
+  for (const auto& line : base::SplitStringPiece(custom_filters, "\r\n",
+                                                 base::TRIM_WHITESPACE,
+                                                 base::SPLIT_WANT_NONEMPTY)) {
+    if (line[0] != '!')
+      rules.insert(line.as_string());
+  }
+  return rules;
+}
+
+}  // namespace
+
 AdBlockCustomFiltersService::AdBlockCustomFiltersService(
-    BraveComponent::Delegate* delegate) : AdBlockBaseService(delegate) {
+    BraveComponent::Delegate* delegate)
+    : AdBlockBaseService(delegate),
+      custom_filters_loaded_(false),
+      stored_in_file_(false),
+      file_generation_(0),
+      file_task_runner_(base::CreateSequencedTaskRunnerWithTraits(
+          {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::BLOCK_SHUTDOWN})),
+      pending_file_write_(new PendingFileWrite()),
+      has_engine_(false),
+      weak_factory_(this) {
 }
 
 AdBlockCustomFiltersService::~AdBlockCustomFiltersService() {
 }
 
 bool AdBlockCustomFiltersService::Init() {
-  return UpdateCustomFilters(GetCustomFilters());
-}
-
-std::string AdBlockCustomFiltersService::GetCustomFilters() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   PrefService* local_state = g_browser_process->local_state();
   if (!local_state)
-    return std::string();
-  return local_state->GetString(kAdBlockCustomFilters);
+    return false;
+
+  std::string custom_filters = local_state->GetString(kAdBlockCustomFilters);
+  if (!custom_filters.empty()) {
+    OnCustomFiltersFileRead(custom_filters);
+    return true;
+  }
+
+  // An empty pref means there are either no custom filters or a large list
+  // in the custom filters file. The file is read on the sequence that writes
+  // it, so the read is ordered with the writes.
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&ReadCustomFiltersFile, GetCustomFiltersFilePath()),
+      base::BindOnce(&AdBlockCustomFiltersService::OnCustomFiltersFileRead,
+                     weak_factory_.GetWeakPtr()));
+  return true;
+}
+
+void AdBlockCustomFiltersService::OnCustomFiltersFileRead(
+    const std::string& custom_filters) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // The user already replaced the list while it was being read.
+  if (custom_filters_loaded_)
+    return;
+  custom_filters_ = custom_filters;
+  stored_in_file_ = custom_filters_.size() > CUSTOM_FILTERS_MAX_PREF_SIZE;
+  SetCustomFiltersLoaded();
+  ScheduleEngineUpdate(custom_filters_);
+}
+
+void AdBlockCustomFiltersService::SetCustomFiltersLoaded() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  custom_filters_loaded_ = true;
+  std::vector<GetCustomFiltersCallback> callbacks;
+  callbacks.swap(pending_get_callbacks_);
+  for (auto& callback : callbacks)
+    std::move(callback).Run(custom_filters_);
+}
+
+void AdBlockCustomFiltersService::GetCustomFilters(
+    GetCustomFiltersCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // Answering before a list in the file is read would show an empty list,
+  // and saving that would replace the file.
+  if (!custom_filters_loaded_) {
+    pending_get_callbacks_.push_back(std::move(callback));
+    return;
+  }
+  std::move(callback).Run(custom_filters_);
 }
 
 bool AdBlockCustomFiltersService::UpdateCustomFilters(
@@ -42,21 +158,120 @@ bool AdBlockCustomFiltersService::UpdateCustomFilters(
   PrefService* local_state = g_browser_process->local_state();
   if (!local_state)
     return false;
-  local_state->SetString(kAdBlockCustomFilters, custom_filters);
+
+  custom_filters_ = custom_filters;
+  if (custom_filters_.size() > CUSTOM_FILTERS_MAX_PREF_SIZE) {
+    // The pref keeps the previous list until the file has the new one.
+    stored_in_file_ = true;
+    ScheduleWriteCustomFiltersFile();
+  } else {
+    local_state->SetString(kAdBlockCustomFilters, custom_filters_);
+    if (stored_in_file_ || !custom_filters_loaded_) {
+      // Empty the file so that it doesn't shadow the pref on the next start.
+      stored_in_file_ = false;
+      ScheduleWriteCustomFiltersFile();
+    }
+  }
+
+  if (!custom_filters_loaded_)
+    SetCustomFiltersLoaded();
+  ScheduleEngineUpdate(custom_filters_);
+  return true;
+}
+
+void AdBlockCustomFiltersService::ScheduleWriteCustomFiltersFile() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  file_generation_++;
+  {
+    base::AutoLock lock(pending_file_write_->lock);
+    const bool write_scheduled = !!pending_file_write_->contents;
+    pending_file_write_->contents = std::make_unique<std::string>(
+        stored_in_file_ ? custom_filters_ : std::string());
+    pending_file_write_->generation = file_generation_;
+    if (write_scheduled)
+      return;
+  }
+
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&WriteCustomFiltersFile, GetCustomFiltersFilePath(),
+                     pending_file_write_),
+      base::BindOnce(&AdBlockCustomFiltersService::OnCustomFiltersFileWritten,
+                     weak_factory_.GetWeakPtr()));
+}
+
+// static
+int AdBlockCustomFiltersService::WriteCustomFiltersFile(
+    const base::FilePath& path,
+    scoped_refptr<PendingFileWrite> pending) {
+  std::unique_ptr<std::string> contents;
+  int generation;
+  {
+    base::AutoLock lock(pending->lock);
+    contents = std::move(pending->contents);
+    generation = pending->generation;
+  }
+  if (!contents)
+    return -1;
+
+  if (!base::ImportantFileWriter::WriteFileAtomically(path, *contents)) {
+    LOG(ERROR) << "Cannot write custom filters file " << path;
+    return -1;
+  }
+  return generation;
+}
+
+void AdBlockCustomFiltersService::OnCustomFiltersFileWritten(int generation) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // Only the write of the latest list may clear the pref. A failed or older
+  // write leaves the previous list in place.
+  if (generation != file_generation_ || !stored_in_file_)
+    return;
+
+  PrefService* local_state = g_browser_process->local_state();
+  if (local_state)
+    local_state->SetString(kAdBlockCustomFilters, std::string());
+}
+
+void AdBlockCustomFiltersService::ScheduleEngineUpdate(
+    const std::string& custom_filters) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  {
+    base::AutoLock lock(pending_custom_filters_lock_);
+    const bool update_scheduled = !!pending_custom_filters_;
+    pending_custom_filters_ = std::make_unique<std::string>(custom_filters);
+    if (update_scheduled)
+      return;
+  }
 
   GetTaskRunner()->PostTask(
       FROM_HERE,
       base::BindOnce(
           &AdBlockCustomFiltersService::UpdateCustomFiltersOnFileTaskRunner,
-          base::Unretained(this), custom_filters));
-
-  return true;
+          base::Unretained(this)));
 }
 
-void AdBlockCustomFiltersService::UpdateCustomFiltersOnFileTaskRunner(
-    const std::string& custom_filters) {
+void AdBlockCustomFiltersService::UpdateCustomFiltersOnFileTaskRunner() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  ad_block_client_.reset(new adblock::Engine(custom_filters.c_str()));
+  std::unique_ptr<std::string> custom_filters;
+  {
+    base::AutoLock lock(pending_custom_filters_lock_);
+    custom_filters = std::move(pending_custom_filters_);
+  }
+  if (!custom_filters)
+    return;
+
+  // adblock::Engine can't add or remove rules from a built engine, so only
+  // rebuild when the set of rules actually changed.
+  std::set<std::string> rules = GetFilterRules(*custom_filters);
+  if (has_engine_ && rules == engine_rules_)
+    return;
+  engine_rules_ = std::move(rules);
+  has_engine_ = true;
+
+  // Parse the rules here and only swap the finished engine in on the IO
+  // thread, where requests are matched against it.
+  SetAdBlockClient(std::make_unique<adblock::Engine>(custom_filters->c_str()));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -7,8 +7,15 @@
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_CUSTOM_FILTERS_SERVICE_H_
 
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/synchronization/lock.h"
 #include "brave/components/brave_shields/browser/ad_block_base_service.h"
 
 class AdBlockServiceTest;
@@ -19,12 +26,22 @@ namespace brave_shields {
 
 // The brave shields service in charge of custom filter ad-block
 // checking and init.
+//
+// Custom filters are kept in the kAdBlockCustomFilters local state pref,
+// except for large lists which are written to a file in the user data
+// directory instead, so they don't bloat local state. The pref is only
+// cleared once the file holds the list.
 class AdBlockCustomFiltersService : public AdBlockBaseService {
  public:
+  using GetCustomFiltersCallback =
+      base::OnceCallback<void(const std::string& custom_filters)>;
+
   explicit AdBlockCustomFiltersService(BraveComponent::Delegate* delegate);
   ~AdBlockCustomFiltersService() override;
 
-  std::string GetCustomFilters();
+  // Runs |callback| with the custom filters, once a list stored in the
+  // custom filters file has been read.
+  void GetCustomFilters(GetCustomFiltersCallback callback);
   bool UpdateCustomFilters(const std::string& custom_filters);
 
  protected:
@@ -32,7 +49,48 @@ class AdBlockCustomFiltersService : public AdBlockBaseService {
 
  private:
   friend class ::AdBlockServiceTest;
-  void UpdateCustomFiltersOnFileTaskRunner(const std::string& custom_filters);
+  friend class AdBlockCustomFiltersServiceTest;
+
+  struct PendingFileWrite;
+
+  // Returns the generation that was written, or -1 if there was nothing to
+  // write or the write failed.
+  static int WriteCustomFiltersFile(const base::FilePath& path,
+                                    scoped_refptr<PendingFileWrite> pending);
+  void OnCustomFiltersFileRead(const std::string& custom_filters);
+  void SetCustomFiltersLoaded();
+  // Queues the file contents for |file_task_runner_|. Edits made while a
+  // write is queued are written together.
+  void ScheduleWriteCustomFiltersFile();
+  void OnCustomFiltersFileWritten(int generation);
+  // Queues |custom_filters| for the file task runner. Edits made while an
+  // engine is being built are coalesced into a single rebuild.
+  void ScheduleEngineUpdate(const std::string& custom_filters);
+  void UpdateCustomFiltersOnFileTaskRunner();
+
+  // Only accessed on the UI thread.
+  std::string custom_filters_;
+  bool custom_filters_loaded_;
+  bool stored_in_file_;
+  std::vector<GetCustomFiltersCallback> pending_get_callbacks_;
+  // Bumped for every write of the custom filters file.
+  int file_generation_;
+
+  // Reads and writes the custom filters file. Writes block shutdown, since
+  // a large list is only in the file once the pref is cleared.
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  scoped_refptr<PendingFileWrite> pending_file_write_;
+
+  // The latest filters not yet picked up by the file task runner.
+  std::unique_ptr<std::string> pending_custom_filters_;
+  base::Lock pending_custom_filters_lock_;
+
+  // The rules the current engine was built from. Only accessed on the file
+  // task runner.
+  std::set<std::string> engine_rules_;
+  bool has_engine_;
+
+  base::WeakPtrFactory<AdBlockCustomFiltersService> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(AdBlockCustomFiltersService);
 };
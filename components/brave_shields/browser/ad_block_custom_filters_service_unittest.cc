@@ -0,0 +1,193 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_custom_filters_service.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/macros.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/scoped_path_override.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "brave/common/pref_names.h"
+#include "chrome/common/chrome_paths.h"
+#include "chrome/test/base/scoped_testing_local_state.h"
+#include "chrome/test/base/testing_browser_process.h"
+#include "components/prefs/pref_service.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+class TestComponentDelegate : public BraveComponent::Delegate {
+ public:
+  TestComponentDelegate() = default;
+  ~TestComponentDelegate() override = default;
+
+  void Register(const std::string& component_name,
+                const std::string& component_base64_public_key,
+                base::OnceClosure registered_callback,
+                BraveComponent::ReadyCallback ready_callback) override {}
+  bool Unregister(const std::string& component_id) override { return true; }
+  void OnDemandUpdate(const std::string& component_id) override {}
+  scoped_refptr<base::SequencedTaskRunner> GetTaskRunner() override {
+    return base::ThreadTaskRunnerHandle::Get();
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TestComponentDelegate);
+};
+
+// A list well over the size that is kept in local state.
+std::string GetLargeCustomFilters(const std::string& domain) {
+  std::string custom_filters;
+  for (int i = 0; i < 2000; i++) {
+    custom_filters += "||ad" + base::NumberToString(i) + "." + domain + "^\n";
+  }
+  return custom_filters;
+}
+
+}  // namespace
+
+class AdBlockCustomFiltersServiceTest : public testing::Test {
+ public:
+  AdBlockCustomFiltersServiceTest()
+      : local_state_(TestingBrowserProcess::GetGlobal()) {}
+  ~AdBlockCustomFiltersServiceTest() override {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    user_data_dir_override_ = std::make_unique<base::ScopedPathOverride>(
+        chrome::DIR_USER_DATA, temp_dir_.GetPath());
+  }
+
+  void TearDown() override {
+    service_.reset();
+    thread_bundle_.RunUntilIdle();
+  }
+
+  // Creates a service as the browser would on startup.
+  void StartService() {
+    service_.reset();
+    service_ = AdBlockCustomFiltersServiceFactory(&delegate_);
+    service_->Start();
+    thread_bundle_.RunUntilIdle();
+  }
+
+  std::string GetCustomFilters() {
+    std::string custom_filters;
+    base::RunLoop run_loop;
+    service_->GetCustomFilters(base::BindOnce(
+        [](std::string* result, base::OnceClosure quit,
+           const std::string& custom_filters) {
+          *result = custom_filters;
+          std::move(quit).Run();
+        },
+        &custom_filters, run_loop.QuitClosure()));
+    run_loop.Run();
+    return custom_filters;
+  }
+
+  std::string GetPref() {
+    return local_state_.Get()->GetString(kAdBlockCustomFilters);
+  }
+
+  std::string ReadCustomFiltersFile() {
+    std::string contents;
+    base::ReadFileToString(temp_dir_.GetPath().Append(
+                               FILE_PATH_LITERAL("AdBlockCustomFilters.txt")),
+                           &contents);
+    return contents;
+  }
+
+  // Replies for a write of the custom filters file that was overtaken by a
+  // newer one.
+  void SimulateStaleFileWritten() {
+    service_->OnCustomFiltersFileWritten(service_->file_generation_ - 1);
+  }
+
+  const void* GetEngine() { return service_->ad_block_client_.get(); }
+
+ protected:
+  content::TestBrowserThreadBundle thread_bundle_;
+  ScopedTestingLocalState local_state_;
+  TestComponentDelegate delegate_;
+  std::unique_ptr<AdBlockCustomFiltersService> service_;
+
+ private:
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<base::ScopedPathOverride> user_data_dir_override_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockCustomFiltersServiceTest);
+};
+
+TEST_F(AdBlockCustomFiltersServiceTest, LargeListMovesToFileAndBack) {
+  local_state_.Get()->SetString(kAdBlockCustomFilters, "||old.com^");
+  StartService();
+  EXPECT_EQ(GetCustomFilters(), "||old.com^");
+
+  const std::string large = GetLargeCustomFilters("example.com");
+  ASSERT_TRUE(service_->UpdateCustomFilters(large));
+  thread_bundle_.RunUntilIdle();
+  EXPECT_EQ(ReadCustomFiltersFile(), large);
+  EXPECT_TRUE(GetPref().empty());
+
+  // The list is read back from the file on the next start.
+  StartService();
+  EXPECT_EQ(GetCustomFilters(), large);
+
+  // A small list goes back to the pref and empties the file.
+  ASSERT_TRUE(service_->UpdateCustomFilters("||new.com^"));
+  thread_bundle_.RunUntilIdle();
+  EXPECT_EQ(GetPref(), "||new.com^");
+  EXPECT_TRUE(ReadCustomFiltersFile().empty());
+
+  StartService();
+  EXPECT_EQ(GetCustomFilters(), "||new.com^");
+}
+
+TEST_F(AdBlockCustomFiltersServiceTest, StaleWriteKeepsPref) {
+  local_state_.Get()->SetString(kAdBlockCustomFilters, "||old.com^");
+  StartService();
+
+  const std::string large = GetLargeCustomFilters("example.com");
+  const std::string larger = GetLargeCustomFilters("example.org");
+  ASSERT_TRUE(service_->UpdateCustomFilters(large));
+  ASSERT_TRUE(service_->UpdateCustomFilters(larger));
+
+  // The file doesn't hold the latest list yet, so the pref must stay.
+  SimulateStaleFileWritten();
+  EXPECT_EQ(GetPref(), "||old.com^");
+
+  thread_bundle_.RunUntilIdle();
+  EXPECT_EQ(ReadCustomFiltersFile(), larger);
+  EXPECT_TRUE(GetPref().empty());
+}
+
+TEST_F(AdBlockCustomFiltersServiceTest, SkipsRebuildForSameRules) {
+  local_state_.Get()->SetString(kAdBlockCustomFilters, "||a.com^\n||b.com^");
+  StartService();
+  const void* engine = GetEngine();
+
+  // Reordered, duplicated, blank and comment lines don't change the rules.
+  ASSERT_TRUE(service_->UpdateCustomFilters(
+      "! comment\n||b.com^\n\n||a.com^\n||a.com^"));
+  thread_bundle_.RunUntilIdle();
+  EXPECT_EQ(GetEngine(), engine);
+
+  ASSERT_TRUE(service_->UpdateCustomFilters("||a.com^\n||c.com^"));
+  thread_bundle_.RunUntilIdle();
+  EXPECT_NE(GetEngine(), engine);
+}
+
+}  // namespace brave_shields
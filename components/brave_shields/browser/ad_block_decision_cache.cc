@@ -0,0 +1,78 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
+
+#include "base/no_destructor.h"
+#include "base/strings/string_number_conversions.h"
+#include "content/public/browser/browser_thread.h"
+#include "url/gurl.h"
+
+#define AD_BLOCK_DECISION_CACHE_SIZE 2000
+// Longer URLs are usually unique, so they'd only push useful entries out.
+#define AD_BLOCK_DECISION_CACHE_MAX_URL_LENGTH 2048
+
+using content::BrowserThread;
+
+namespace brave_shields {
+
+AdBlockDecisionCache::AdBlockDecisionCache(size_t size) : decisions_(size) {}
+
+AdBlockDecisionCache::~AdBlockDecisionCache() {}
+
+// static
+AdBlockDecisionCache* AdBlockDecisionCache::GetInstance() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  static base::NoDestructor<AdBlockDecisionCache> instance(
+      AD_BLOCK_DECISION_CACHE_SIZE);
+  return instance.get();
+}
+
+// static
+bool AdBlockDecisionCache::GetKey(const GURL& url,
+                                  content::ResourceType resource_type,
+                                  const std::string& tab_host,
+                                  std::string* key) {
+  const std::string& spec = url.possibly_invalid_spec();
+  if (spec.size() > AD_BLOCK_DECISION_CACHE_MAX_URL_LENGTH)
+    return false;
+  // Neither the resource type number nor a host contains a space.
+  *key = base::NumberToString(static_cast<int>(resource_type));
+  key->append(" ");
+  key->append(tab_host);
+  key->append(" ");
+  key->append(spec);
+  return true;
+}
+
+bool AdBlockDecisionCache::Get(const GURL& url,
+                               content::ResourceType resource_type,
+                               const std::string& tab_host,
+                               Decision* decision) {
+  std::string key;
+  if (!GetKey(url, resource_type, tab_host, &key))
+    return false;
+  auto it = decisions_.Get(key);
+  if (it == decisions_.end())
+    return false;
+  *decision = it->second;
+  return true;
+}
+
+void AdBlockDecisionCache::Put(const GURL& url,
+                               content::ResourceType resource_type,
+                               const std::string& tab_host,
+                               const Decision& decision) {
+  std::string key;
+  if (!GetKey(url, resource_type, tab_host, &key))
+    return;
+  decisions_.Put(key, decision);
+}
+
+void AdBlockDecisionCache::Invalidate() {
+  decisions_.Clear();
+}
+
+}  // namespace brave_shields
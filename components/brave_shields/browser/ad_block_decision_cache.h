@@ -0,0 +1,63 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_DECISION_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_DECISION_CACHE_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "content/public/common/resource_type.h"
+
+class GURL;
+
+namespace brave_shields {
+
+// Remembers the combined verdict of the default, regional and custom ad block
+// engines for a (tab host, request URL, resource type), so that resources a
+// page requests over and over skip the engines. Every cached decision is
+// dropped as soon as any engine is replaced or its tags change.
+//
+// Only used on the IO thread.
+class AdBlockDecisionCache {
+ public:
+  struct Decision {
+    bool should_block;
+    bool cancel_request_explicitly;
+  };
+
+  explicit AdBlockDecisionCache(size_t size);
+  ~AdBlockDecisionCache();
+
+  // The cache shared by the ad block network delegate helper and the
+  // services that invalidate it.
+  static AdBlockDecisionCache* GetInstance();
+
+  bool Get(const GURL& url,
+           content::ResourceType resource_type,
+           const std::string& tab_host,
+           Decision* decision);
+  void Put(const GURL& url,
+           content::ResourceType resource_type,
+           const std::string& tab_host,
+           const Decision& decision);
+  void Invalidate();
+
+ private:
+  // Returns false for requests that aren't worth caching.
+  static bool GetKey(const GURL& url,
+                     content::ResourceType resource_type,
+                     const std::string& tab_host,
+                     std::string* key);
+
+  base::HashingMRUCache<std::string, Decision> decisions_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockDecisionCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_DECISION_CACHE_H_
@@ -0,0 +1,65 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+TEST(AdBlockDecisionCacheTest, KeyedByTabHostURLAndResourceType) {
+  AdBlockDecisionCache cache(10);
+  const GURL url("https://tracker.example.com/pixel.gif");
+  cache.Put(url, content::ResourceType::kImage, "brave.com", {true, true});
+
+  AdBlockDecisionCache::Decision decision = {false, false};
+  ASSERT_TRUE(cache.Get(url, content::ResourceType::kImage, "brave.com",
+                        &decision));
+  EXPECT_TRUE(decision.should_block);
+  EXPECT_TRUE(decision.cancel_request_explicitly);
+
+  EXPECT_FALSE(cache.Get(url, content::ResourceType::kScript, "brave.com",
+                         &decision));
+  EXPECT_FALSE(cache.Get(url, content::ResourceType::kImage, "example.com",
+                         &decision));
+  EXPECT_FALSE(cache.Get(GURL("https://tracker.example.com/other.gif"),
+                         content::ResourceType::kImage, "brave.com",
+                         &decision));
+}
+
+TEST(AdBlockDecisionCacheTest, InvalidateAndEvict) {
+  AdBlockDecisionCache cache(2);
+  const GURL url1("https://a.com/1.js");
+  const GURL url2("https://a.com/2.js");
+  const GURL url3("https://a.com/3.js");
+  cache.Put(url1, content::ResourceType::kScript, "brave.com", {true, false});
+  cache.Put(url2, content::ResourceType::kScript, "brave.com", {false, false});
+  cache.Put(url3, content::ResourceType::kScript, "brave.com", {false, false});
+
+  AdBlockDecisionCache::Decision decision;
+  EXPECT_FALSE(cache.Get(url1, content::ResourceType::kScript, "brave.com",
+                         &decision));
+  EXPECT_TRUE(cache.Get(url3, content::ResourceType::kScript, "brave.com",
+                        &decision));
+
+  cache.Invalidate();
+  EXPECT_FALSE(cache.Get(url3, content::ResourceType::kScript, "brave.com",
+                         &decision));
+}
+
+TEST(AdBlockDecisionCacheTest, SkipsLongURLs) {
+  AdBlockDecisionCache cache(10);
+  const GURL url("https://a.com/" + std::string(4096, 'a'));
+  cache.Put(url, content::ResourceType::kImage, "brave.com", {true, false});
+
+  AdBlockDecisionCache::Decision decision;
+  EXPECT_FALSE(cache.Get(url, content::ResourceType::kImage, "brave.com",
+                         &decision));
+}
+
+}  // namespace brave_shields
@@ -14,6 +14,7 @@
 #include "base/values.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/pref_names.h"
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
@@ -87,6 +88,12 @@ void AdBlockRegionalServiceManager::StartRegionalServices() {
           std::make_pair(uuid, std::move(regional_service)));
     }
   }
+
+  base::PostTaskWithTraits(
+      FROM_HERE, {content::BrowserThread::IO},
+      base::BindOnce(
+          &AdBlockRegionalServiceManager::SetRegionalServicesOnIOThread,
+          base::Unretained(this), GetRegionalServicesSnapshot()));
 }
 
 void AdBlockRegionalServiceManager::UpdateFilterListPrefs(
@@ -103,6 +110,24 @@ void AdBlockRegionalServiceManager::UpdateFilterListPrefs(
   regional_filters_dict->Set(uuid, std::move(regional_filter_dict));
 }
 
+std::vector<AdBlockRegionalService*>
+AdBlockRegionalServiceManager::GetRegionalServicesSnapshot() {
+  regional_services_lock_.AssertAcquired();
+  std::vector<AdBlockRegionalService*> regional_services;
+  regional_services.reserve(regional_services_.size());
+  for (const auto& regional_service : regional_services_) {
+    regional_services.push_back(regional_service.second.get());
+  }
+  return regional_services;
+}
+
+void AdBlockRegionalServiceManager::SetRegionalServicesOnIOThread(
+    std::vector<AdBlockRegionalService*> regional_services) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  regional_services_io_.swap(regional_services);
+  AdBlockDecisionCache::GetInstance()->Invalidate();
+}
+
 bool AdBlockRegionalServiceManager::IsInitialized() const {
   return initialized_;
 }
@@ -129,11 +154,19 @@ bool AdBlockRegionalServiceManager::ShouldStartRequest(
     const std::string& tab_host,
     bool* matching_exception_filter,
     bool* cancel_request_explicitly) {
-  base::AutoLock lock(regional_services_lock_);
-  for (const auto& regional_service : regional_services_) {
-    if (!regional_service.second->ShouldStartRequest(
-            url, resource_type, tab_host, matching_exception_filter,
-            cancel_request_explicitly)) {
+  return ShouldStartRequest(AdBlockMatchContext(url, resource_type, tab_host),
+                            matching_exception_filter,
+                            cancel_request_explicitly);
+}
+
+bool AdBlockRegionalServiceManager::ShouldStartRequest(
+    const AdBlockMatchContext& context,
+    bool* matching_exception_filter,
+    bool* cancel_request_explicitly) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  for (auto* regional_service : regional_services_io_) {
+    if (!regional_service->ShouldStartRequest(
+            context, matching_exception_filter, cancel_request_explicitly)) {
       return false;
     }
     if (matching_exception_filter && *matching_exception_filter) {
@@ -160,6 +193,7 @@ void AdBlockRegionalServiceManager::EnableFilterList(const std::string& uuid,
   {
     base::AutoLock lock(regional_services_lock_);
     auto it = regional_services_.find(uuid);
+    std::unique_ptr<AdBlockRegionalService> removed_service;
     if (enabled) {
       DCHECK(it == regional_services_.end());
       auto regional_service = AdBlockRegionalServiceFactory(uuid, delegate_);
@@ -170,8 +204,21 @@ void AdBlockRegionalServiceManager::EnableFilterList(const std::string& uuid,
       DCHECK(it != regional_services_.end());
       it->second->Stop();
       it->second->Unregister();
+      removed_service = std::move(it->second);
       regional_services_.erase(it);
     }
+
+    // Publish the new set of services to the IO thread. A disabled service
+    // may still be referenced by the current snapshot, so it is only
+    // destroyed once the new snapshot has been swapped in.
+    base::PostTaskWithTraitsAndReply(
+        FROM_HERE, {content::BrowserThread::IO},
+        base::BindOnce(
+            &AdBlockRegionalServiceManager::SetRegionalServicesOnIOThread,
+            base::Unretained(this), GetRegionalServicesSnapshot()),
+        base::BindOnce(
+            [](std::unique_ptr<AdBlockRegionalService> regional_service) {},
+            std::move(removed_service)));
   }
 
   // Update preferences to reflect enabled/disabled state of specified
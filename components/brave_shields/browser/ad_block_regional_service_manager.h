@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/memory/scoped_refptr.h"
@@ -28,6 +29,7 @@ using brave_component_updater::BraveComponent;
 namespace brave_shields {
 
 class AdBlockRegionalService;
+struct AdBlockMatchContext;
 
 // The AdBlock regional service manager, in charge of initializing and
 // managing regional AdBlock clients.
@@ -47,6 +49,9 @@ class AdBlockRegionalServiceManager {
                           const std::string& tab_host,
                           bool* matching_exception_filter,
                           bool* cancel_request_explicitly);
+  bool ShouldStartRequest(const AdBlockMatchContext& context,
+                          bool* matching_exception_filter,
+                          bool* cancel_request_explicitly);
   void EnableTag(const std::string& tag, bool enabled);
   void EnableFilterList(const std::string& uuid, bool enabled);
 
@@ -55,12 +60,22 @@ class AdBlockRegionalServiceManager {
   bool Init();
   void StartRegionalServices();
   void UpdateFilterListPrefs(const std::string& uuid, bool enabled);
+  std::vector<AdBlockRegionalService*> GetRegionalServicesSnapshot();
+  void SetRegionalServicesOnIOThread(
+      std::vector<AdBlockRegionalService*> regional_services);
 
   brave_component_updater::BraveComponent::Delegate* delegate_;  // NOT OWNED
   bool initialized_;
+  // Guards |regional_services_|, which owns the services. It is never taken
+  // on the request path.
   base::Lock regional_services_lock_;
   std::map<std::string, std::unique_ptr<AdBlockRegionalService>>
       regional_services_;
+  // The services consulted for each request. Only read and replaced on the
+  // IO thread: a new snapshot is built whenever |regional_services_| changes
+  // and swapped in by a posted task, so request matching needs no lock.
+  // Removed services are destroyed only after the swap has run.
+  std::vector<AdBlockRegionalService*> regional_services_io_;
 
   DISALLOW_COPY_AND_ASSIGN(AdBlockRegionalServiceManager);
 };
@@ -6,8 +6,14 @@
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include "base/containers/mru_cache.h"
+#include "base/no_destructor.h"
 #include "base/task/post_task.h"
+#include "base/threading/thread_local_storage.h"
+#include "base/timer/timer.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/shield_exceptions.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
@@ -33,10 +39,31 @@ using content::ResourceContext;
 using content::ResourceRequestInfo;
 using net::URLRequest;
 
+#define ETLD_PLUS_ONE_CACHE_SIZE 256
+#define BLOCKED_EVENTS_FLUSH_DELAY_MS 200
+
 namespace brave_shields {
 
 namespace {
 
+using ETLDPlusOneCache = base::HashingMRUCache<std::string, std::string>;
+
+void DeleteETLDPlusOneCache(void* cache) {
+  delete static_cast<ETLDPlusOneCache*>(cache);
+}
+
+// Each thread gets its own cache so lookups never take a lock.
+ETLDPlusOneCache* GetETLDPlusOneCacheForCurrentThread() {
+  static base::NoDestructor<base::ThreadLocalStorage::Slot> slot(
+      &DeleteETLDPlusOneCache);
+  auto* cache = static_cast<ETLDPlusOneCache*>(slot->Get());
+  if (!cache) {
+    cache = new ETLDPlusOneCache(ETLD_PLUS_ONE_CACHE_SIZE);
+    slot->Set(cache);
+  }
+  return cache;
+}
+
 ContentSetting GetDefaultAllowFromControlType(ControlType type) {
   if (type == ControlType::DEFAULT)
     return CONTENT_SETTING_DEFAULT;
@@ -53,8 +80,36 @@ ContentSetting GetDefaultBlockFromControlType(ControlType type) {
                                     : CONTENT_SETTING_BLOCK;
 }
 
+// Blocked events raised on the IO thread that haven't been sent to the UI
+// thread yet. Only accessed on the IO thread.
+std::vector<BlockedEvent>* PendingBlockedEvents() {
+  static base::NoDestructor<std::vector<BlockedEvent>> pending_events;
+  return pending_events.get();
+}
+
+base::OneShotTimer* BlockedEventsFlushTimer() {
+  static base::NoDestructor<base::OneShotTimer> timer;
+  return timer.get();
+}
+
 }  // namespace
 
+void FlushBlockedEventsOnIO() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  BlockedEventsFlushTimer()->Stop();
+  std::vector<BlockedEvent>* pending_events = PendingBlockedEvents();
+  if (pending_events->empty()) {
+    return;
+  }
+
+  std::vector<BlockedEvent> events;
+  events.swap(*pending_events);
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::UI},
+      base::BindOnce(&BraveShieldsWebContentsObserver::DispatchBlockedEvents,
+                     std::move(events)));
+}
+
 ContentSettingsPattern GetPatternFromURL(const GURL& url,
                                          bool scheme_wildcard) {
   DCHECK(url.is_empty() ? url.possibly_invalid_spec() == "" : url.is_valid());
@@ -398,11 +453,46 @@ void DispatchBlockedEventFromIO(const GURL& request_url,
                                 int frame_tree_node_id,
                                 const std::string& block_type) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
-  base::PostTaskWithTraits(
-      FROM_HERE, {BrowserThread::UI},
-      base::BindOnce(&BraveShieldsWebContentsObserver::DispatchBlockedEvent,
-                     block_type, request_url.spec(), render_process_id,
-                     render_frame_id, frame_tree_node_id));
+  // Coalesce everything that is blocked within a short window into a single
+  // UI task, instead of posting one per resource. A finished page load sends
+  // the batch early.
+  std::vector<BlockedEvent>* pending_events = PendingBlockedEvents();
+  if (pending_events->empty()) {
+    BlockedEventsFlushTimer()->Start(
+        FROM_HERE,
+        base::TimeDelta::FromMilliseconds(BLOCKED_EVENTS_FLUSH_DELAY_MS),
+        base::BindOnce(&FlushBlockedEventsOnIO));
+  }
+  pending_events->push_back(BlockedEvent{block_type, request_url.spec(),
+                                         render_process_id, render_frame_id,
+                                         frame_tree_node_id,
+                                         base::TimeTicks::Now()});
+}
+
+std::string GetETLDPlusOne(base::StringPiece host) {
+  if (host.empty())
+    return std::string();
+
+  ETLDPlusOneCache* cache = GetETLDPlusOneCacheForCurrentThread();
+  const std::string key = host.as_string();
+  auto it = cache->Get(key);
+  if (it != cache->end())
+    return it->second;
+
+  std::string etld_plus_one =
+      net::registry_controlled_domains::GetDomainAndRegistry(
+          host, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  cache->Put(key, etld_plus_one);
+  return etld_plus_one;
+}
+
+bool IsSameDomainOrHost(base::StringPiece host1, base::StringPiece host2) {
+  if (host1.empty() || host2.empty())
+    return false;
+  if (host1 == host2)
+    return true;
+  const std::string domain1 = GetETLDPlusOne(host1);
+  return !domain1.empty() && domain1 == GetETLDPlusOne(host2);
 }
 
 bool ShouldSetReferrer(bool allow_referrers,
@@ -416,9 +506,8 @@ bool ShouldSetReferrer(bool allow_referrers,
   if (!output_referrer || allow_referrers || !shields_up ||
       original_referrer.is_empty() ||
       // Same TLD+1 whouldn't set the referrer
-      SameDomainOrHost(
-          target_url, original_referrer,
-          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES) ||
+      IsSameDomainOrHost(target_url.host_piece(),
+                         original_referrer.host_piece()) ||
       // Whitelisted referrers shoud never set the referrer
       (g_brave_browser_process &&
        g_brave_browser_process->referrer_whitelist_service()->IsWhitelisted(
@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <string>
 
+#include "base/strings/string_piece.h"
 #include "components/content_settings/core/common/content_settings_pattern.h"
 #include "components/content_settings/core/common/content_settings_types.h"
 #include "services/network/public/mojom/referrer_policy.mojom.h"
@@ -86,11 +87,24 @@ void DispatchBlockedEventFromIO(const GURL& request_url,
                                 int frame_tree_node_id,
                                 const std::string& block_type);
 
+// Sends the blocked events batched by DispatchBlockedEventFromIO to the UI
+// thread without waiting for the batch window to end.
+void FlushBlockedEventsOnIO();
+
 void GetRenderFrameInfo(const net::URLRequest* request,
                         int* render_frame_id,
                         int* render_process_id,
                         int* frame_tree_node_id);
 
+// Returns the registrable domain (eTLD+1) of |host|, including private
+// registries, or an empty string when it has none. Results are kept in a
+// small per-thread MRU cache, since requests mostly go to a few hosts.
+std::string GetETLDPlusOne(base::StringPiece host);
+
+// Same result as net::registry_controlled_domains::SameDomainOrHost() with
+// INCLUDE_PRIVATE_REGISTRIES, but using GetETLDPlusOne().
+bool IsSameDomainOrHost(base::StringPiece host1, base::StringPiece host2);
+
 bool ShouldSetReferrer(bool allow_referrers,
                        bool shields_up,
                        const GURL& original_referrer,
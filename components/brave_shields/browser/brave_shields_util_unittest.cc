@@ -1188,3 +1188,32 @@ TEST_F(BraveShieldsUtilTest, GetNoScriptControlType_ForOrigin) {
   setting = brave_shields::GetNoScriptControlType(profile(), GURL());
   EXPECT_EQ(ControlType::BLOCK, setting);
 }
+
+TEST_F(BraveShieldsUtilTest, GetETLDPlusOne) {
+  EXPECT_EQ("brave.com", brave_shields::GetETLDPlusOne("brave.com"));
+  EXPECT_EQ("brave.com", brave_shields::GetETLDPlusOne("www.brave.com"));
+  // Repeated lookups are served from the cache with the same result.
+  EXPECT_EQ("brave.com", brave_shields::GetETLDPlusOne("www.brave.com"));
+  EXPECT_EQ("example.co.uk",
+            brave_shields::GetETLDPlusOne("a.b.example.co.uk"));
+  // Private registries are included.
+  EXPECT_EQ("brave.github.io",
+            brave_shields::GetETLDPlusOne("brave.github.io"));
+  EXPECT_EQ("", brave_shields::GetETLDPlusOne("com"));
+  EXPECT_EQ("", brave_shields::GetETLDPlusOne("127.0.0.1"));
+  EXPECT_EQ("", brave_shields::GetETLDPlusOne(""));
+}
+
+TEST_F(BraveShieldsUtilTest, IsSameDomainOrHost) {
+  EXPECT_TRUE(brave_shields::IsSameDomainOrHost("brave.com", "brave.com"));
+  EXPECT_TRUE(
+      brave_shields::IsSameDomainOrHost("www.brave.com", "cdn.brave.com"));
+  EXPECT_TRUE(brave_shields::IsSameDomainOrHost("127.0.0.1", "127.0.0.1"));
+  EXPECT_TRUE(brave_shields::IsSameDomainOrHost("localhost", "localhost"));
+  EXPECT_FALSE(brave_shields::IsSameDomainOrHost("brave.com", "brave2.com"));
+  EXPECT_FALSE(brave_shields::IsSameDomainOrHost("a.github.io",
+                                                 "b.github.io"));
+  EXPECT_FALSE(brave_shields::IsSameDomainOrHost("com", "brave.com"));
+  EXPECT_FALSE(brave_shields::IsSameDomainOrHost("", ""));
+  EXPECT_FALSE(brave_shields::IsSameDomainOrHost("brave.com", ""));
+}
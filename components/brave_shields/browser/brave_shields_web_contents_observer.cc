@@ -11,21 +11,21 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/post_task.h"
 #include "brave/common/pref_names.h"
 #include "brave/common/render_messages.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "brave/components/brave_shields/browser/renderer_content_setting_rules_tracker.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/content/common/frame_messages.h"
-#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
 #include "chrome/browser/profiles/profile.h"
-#include "chrome/common/renderer_configuration.mojom.h"
-#include "components/content_settings/core/browser/host_content_settings_map.h"
-#include "components/content_settings/core/common/content_settings_utils.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
 #include "content/browser/frame_host/frame_tree_node.h"
 #include "content/browser/frame_host/navigator.h"
+#include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/navigation_entry.h"
 #include "content/public/browser/navigation_handle.h"
@@ -46,39 +46,13 @@ using extensions::Event;
 using extensions::EventRouter;
 #endif
 
+using content::BrowserThread;
 using content::Referrer;
 using content::RenderFrameHost;
 using content::WebContents;
 
 namespace {
 
-// Content Settings are only sent to the main frame currently.
-// Chrome may fix this at some point, but for now we do this as a work-around.
-// You can verify if this is fixed by running the following test:
-// npm run test -- brave_browser_tests --filter=BraveContentSettingsObserverBrowserTest.*  // NOLINT
-// Chrome seems to also have a bug with RenderFrameHostChanged not updating
-// the content settings so this is fixed here too. That case is covered in
-// tests by:
-// npm run test -- brave_browser_tests --filter=BraveContentSettingsObserverBrowserTest.*  // NOLINT
-void UpdateContentSettingsToRendererFrames(content::WebContents* web_contents) {
-  for (content::RenderFrameHost* frame : web_contents->GetAllFrames()) {
-    Profile* profile =
-        Profile::FromBrowserContext(web_contents->GetBrowserContext());
-    const HostContentSettingsMap* map =
-        HostContentSettingsMapFactory::GetForProfile(profile);
-    RendererContentSettingRules rules;
-    GetRendererContentSettingRules(map, &rules);
-    IPC::ChannelProxy* channel =
-        frame->GetProcess()->GetChannel();
-    // channel might be NULL in tests.
-    if (channel) {
-      chrome::mojom::RendererConfigurationAssociatedPtr rc_interface;
-      channel->GetRemoteAssociatedInterface(&rc_interface);
-      rc_interface->SetContentSettingRules(rules);
-    }
-  }
-}
-
 WebContents* GetWebContents(
     int render_process_id,
     int render_frame_id,
@@ -97,38 +71,50 @@ WebContents* GetWebContents(
   return web_contents;
 }
 
-}  // namespace
-
-namespace brave_shields {
-
-base::Lock BraveShieldsWebContentsObserver::frame_data_map_lock_;
-std::map<BraveShieldsWebContentsObserver::RenderFrameIdKey, GURL>
-    BraveShieldsWebContentsObserver::frame_key_to_tab_url_;
-std::map<int, GURL>
-    BraveShieldsWebContentsObserver::frame_tree_node_id_to_tab_url_;
+const char* GetBlockedCountPrefName(const std::string& block_type) {
+  if (block_type == brave_shields::kAds) {
+    return kAdsBlocked;
+  } else if (block_type == brave_shields::kHTTPUpgradableResources) {
+    return kHttpsUpgrades;
+  } else if (block_type == brave_shields::kJavaScript) {
+    return kJavascriptBlocked;
+  } else if (block_type == brave_shields::kFingerprinting) {
+    return kFingerprintingBlocked;
+  }
+  return nullptr;
+}
 
-BraveShieldsWebContentsObserver::RenderFrameIdKey::RenderFrameIdKey()
-    : render_process_id(content::ChildProcessHost::kInvalidUniqueID),
-      frame_routing_id(MSG_ROUTING_NONE) {}
+void SetTabURLOnIO(int render_process_id,
+                   int render_frame_id,
+                   int frame_tree_node_id,
+                   scoped_refptr<const brave_shields::TabURL> tab_url) {
+  brave_shields::FrameTabURLMap::GetInstance()->SetTabURL(
+      render_process_id, render_frame_id, frame_tree_node_id,
+      std::move(tab_url));
+}
 
-BraveShieldsWebContentsObserver::RenderFrameIdKey::RenderFrameIdKey(
-    int render_process_id,
-    int frame_routing_id)
-    : render_process_id(render_process_id),
-      frame_routing_id(frame_routing_id) {}
-
-bool BraveShieldsWebContentsObserver::RenderFrameIdKey::operator<(
-    const RenderFrameIdKey& other) const {
-  return std::tie(render_process_id, frame_routing_id) <
-         std::tie(other.render_process_id, other.frame_routing_id);
+void RemoveFrameOnIO(int render_process_id,
+                     int render_frame_id,
+                     int frame_tree_node_id) {
+  brave_shields::FrameTabURLMap::GetInstance()->RemoveFrame(
+      render_process_id, render_frame_id, frame_tree_node_id);
 }
 
-bool BraveShieldsWebContentsObserver::RenderFrameIdKey::operator==(
-    const RenderFrameIdKey& other) const {
-  return render_process_id == other.render_process_id &&
-         frame_routing_id == other.frame_routing_id;
+// Frame updates are posted in the order they happen, so the IO thread always
+// ends up with the UI thread's view of the frames.
+void PostSetTabURL(RenderFrameHost* rfh,
+                   scoped_refptr<const brave_shields::TabURL> tab_url) {
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::IO},
+      base::BindOnce(&SetTabURLOnIO, rfh->GetProcess()->GetID(),
+                     rfh->GetRoutingID(), rfh->GetFrameTreeNodeId(),
+                     std::move(tab_url)));
 }
 
+}  // namespace
+
+namespace brave_shields {
+
 BraveShieldsWebContentsObserver::~BraveShieldsWebContentsObserver() {
 }
 
@@ -139,74 +125,92 @@ BraveShieldsWebContentsObserver::BraveShieldsWebContentsObserver(
 
 void BraveShieldsWebContentsObserver::RenderFrameCreated(
     RenderFrameHost* rfh) {
-  if (rfh && allowed_script_origins_.size()) {
-    rfh->Send(new BraveFrameMsg_AllowScriptsOnce(
-          rfh->GetRoutingID(), allowed_script_origins_));
-  }
-
   WebContents* web_contents = WebContents::FromRenderFrameHost(rfh);
   if (web_contents) {
-    UpdateContentSettingsToRendererFrames(web_contents);
-
-    base::AutoLock lock(frame_data_map_lock_);
-    const RenderFrameIdKey key(rfh->GetProcess()->GetID(), rfh->GetRoutingID());
-    frame_key_to_tab_url_[key] = web_contents->GetURL();
-    frame_tree_node_id_to_tab_url_[rfh->GetFrameTreeNodeId()] =
-        web_contents->GetURL();
+    // Chrome only sends content settings for the main frame's process, and
+    // misses the new process on RenderFrameHostChanged, so every process of
+    // the tab is sent the rules here. The rules are process-wide, so they are
+    // tracked per profile rather than per tab.
+    // npm run test -- brave_browser_tests --filter=BraveContentSettingsObserverBrowserTest.*  // NOLINT
+    RendererContentSettingRulesTracker::FromProfile(
+        Profile::FromBrowserContext(web_contents->GetBrowserContext()))
+        ->AddFrame(rfh->GetProcess(), rfh->GetRoutingID());
   }
+  SetUpFrame(rfh);
 }
 
 void BraveShieldsWebContentsObserver::RenderFrameDeleted(
     RenderFrameHost* rfh) {
-  base::AutoLock lock(frame_data_map_lock_);
-  const RenderFrameIdKey key(rfh->GetProcess()->GetID(), rfh->GetRoutingID());
-  frame_key_to_tab_url_.erase(key);
-  frame_tree_node_id_to_tab_url_.erase(rfh->GetFrameTreeNodeId());
+  RendererContentSettingRulesTracker::FromProfile(
+      Profile::FromBrowserContext(rfh->GetProcess()->GetBrowserContext()))
+      ->RemoveFrame(rfh->GetProcess(), rfh->GetRoutingID());
+  TearDownFrame(rfh);
 }
 
 void BraveShieldsWebContentsObserver::RenderFrameHostChanged(
     RenderFrameHost* old_host, RenderFrameHost* new_host) {
+  // Content reports the frames of both hosts through RenderFrameCreated and
+  // RenderFrameDeleted, so only the per-tab state follows the swap here.
   if (old_host) {
-    RenderFrameDeleted(old_host);
+    TearDownFrame(old_host);
   }
   if (new_host) {
-    RenderFrameCreated(new_host);
+    SetUpFrame(new_host);
   }
 }
 
+void BraveShieldsWebContentsObserver::SetUpFrame(RenderFrameHost* rfh) {
+  if (rfh && allowed_script_origins_.size()) {
+    rfh->Send(new BraveFrameMsg_AllowScriptsOnce(
+          rfh->GetRoutingID(), allowed_script_origins_));
+  }
+  if (WebContents::FromRenderFrameHost(rfh)) {
+    PostSetTabURL(rfh, GetTabURLSnapshot());
+  }
+}
+
+void BraveShieldsWebContentsObserver::TearDownFrame(RenderFrameHost* rfh) {
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::IO},
+      base::BindOnce(&RemoveFrameOnIO, rfh->GetProcess()->GetID(),
+                     rfh->GetRoutingID(), rfh->GetFrameTreeNodeId()));
+}
+
 void BraveShieldsWebContentsObserver::DidFinishNavigation(
     content::NavigationHandle* navigation_handle) {
   RenderFrameHost* main_frame = web_contents()->GetMainFrame();
   if (!web_contents() || !main_frame) {
     return;
   }
-  int process_id = main_frame->GetProcess()->GetID();
-  int routing_id = main_frame->GetRoutingID();
-  int tree_node_id = main_frame->GetFrameTreeNodeId();
+  PostSetTabURL(main_frame, GetTabURLSnapshot());
+}
 
-  base::AutoLock lock(frame_data_map_lock_);
-  frame_key_to_tab_url_[{process_id, routing_id}] = web_contents()->GetURL();
-  frame_tree_node_id_to_tab_url_[tree_node_id] = web_contents()->GetURL();
+void BraveShieldsWebContentsObserver::DidFinishLoad(
+    RenderFrameHost* render_frame_host,
+    const GURL& validated_url) {
+  if (render_frame_host->GetParent()) {
+    return;
+  }
+  // Show the final blocked counts for the page without waiting for the batch
+  // window to end.
+  base::PostTaskWithTraits(FROM_HERE, {BrowserThread::IO},
+                           base::BindOnce(&FlushBlockedEventsOnIO));
+}
+
+scoped_refptr<const TabURL>
+BraveShieldsWebContentsObserver::GetTabURLSnapshot() {
+  const GURL& url = web_contents()->GetURL();
+  if (!tab_url_ || tab_url_->data != url) {
+    tab_url_ = base::MakeRefCounted<TabURL>(url);
+  }
+  return tab_url_;
 }
 
 // static
-GURL BraveShieldsWebContentsObserver::GetTabURLFromRenderFrameInfo(
+const GURL& BraveShieldsWebContentsObserver::GetTabURLFromRenderFrameInfo(
     int render_process_id, int render_frame_id, int render_frame_tree_node_id) {
-  base::AutoLock lock(frame_data_map_lock_);
-  if (-1 != render_process_id && -1 != render_frame_id) {
-    auto iter = frame_key_to_tab_url_.find({render_process_id,
-                                            render_frame_id});
-    if (iter != frame_key_to_tab_url_.end()) {
-      return iter->second;
-    }
-  }
-  if (-1 != render_frame_tree_node_id) {
-    auto iter2 = frame_tree_node_id_to_tab_url_.find(render_frame_tree_node_id);
-    if (iter2 != frame_tree_node_id_to_tab_url_.end()) {
-      return iter2->second;
-    }
-  }
-  return GURL();
+  return FrameTabURLMap::GetInstance()->GetTabURL(
+      render_process_id, render_frame_id, render_frame_tree_node_id);
 }
 
 bool BraveShieldsWebContentsObserver::IsBlockedSubresource(
@@ -220,40 +224,47 @@ void BraveShieldsWebContentsObserver::AddBlockedSubresource(
 }
 
 // static
-void BraveShieldsWebContentsObserver::DispatchBlockedEvent(
-    std::string block_type,
-    std::string subresource,
-    int render_process_id,
-    int render_frame_id,
-    int frame_tree_node_id) {
+void BraveShieldsWebContentsObserver::DispatchBlockedEvents(
+    std::vector<BlockedEvent> events) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
-  WebContents* web_contents = GetWebContents(render_process_id,
-    render_frame_id, frame_tree_node_id);
-  DispatchBlockedEventForWebContents(block_type, subresource, web_contents);
+  // Sum up the stats of the whole batch so that each pref is written once.
+  std::map<PrefService*, std::map<const char*, uint64_t>> blocked_counts;
+  for (const auto& event : events) {
+    WebContents* web_contents = GetWebContents(event.render_process_id,
+        event.render_frame_id, event.frame_tree_node_id);
+    if (!web_contents) {
+      continue;
+    }
 
-  if (web_contents) {
+    // The batch may have waited for a navigation of the tab to commit; what
+    // the previous page blocked doesn't count for the new one.
     BraveShieldsWebContentsObserver* observer =
         BraveShieldsWebContentsObserver::FromWebContents(web_contents);
-    if (observer &&
-        !observer->IsBlockedSubresource(subresource)) {
-      observer->AddBlockedSubresource(subresource);
+    if (observer && event.raised_at < observer->page_committed_at_) {
+      continue;
+    }
+    DispatchBlockedEventForWebContents(event.block_type, event.subresource,
+                                       web_contents);
+    if (!observer || observer->IsBlockedSubresource(event.subresource)) {
+      continue;
+    }
+    observer->AddBlockedSubresource(event.subresource);
+    const char* pref_name = GetBlockedCountPrefName(event.block_type);
+    if (pref_name) {
       PrefService* prefs = Profile::FromBrowserContext(
           web_contents->GetBrowserContext())->
           GetOriginalProfile()->
           GetPrefs();
+      blocked_counts[prefs][pref_name]++;
+    }
+  }
 
-      if (block_type == kAds) {
-        prefs->SetUint64(kAdsBlocked, prefs->GetUint64(kAdsBlocked) + 1);
-      } else if (block_type == kHTTPUpgradableResources) {
-        prefs->SetUint64(kHttpsUpgrades, prefs->GetUint64(kHttpsUpgrades) + 1);
-      } else if (block_type == kJavaScript) {
-        prefs->SetUint64(kJavascriptBlocked,
-            prefs->GetUint64(kJavascriptBlocked) + 1);
-      } else if (block_type == kFingerprinting) {
-        prefs->SetUint64(kFingerprintingBlocked,
-            prefs->GetUint64(kFingerprintingBlocked) + 1);
-      }
+  for (const auto& prefs_counts : blocked_counts) {
+    PrefService* prefs = prefs_counts.first;
+    for (const auto& pref_count : prefs_counts.second) {
+      prefs->SetUint64(pref_count.first,
+                       prefs->GetUint64(pref_count.first) + pref_count.second);
     }
   }
 }
@@ -344,6 +355,7 @@ void BraveShieldsWebContentsObserver::ReadyToCommitNavigation(
       navigation_handle->GetReloadType() == content::ReloadType::NONE) {
     allowed_script_origins_.clear();
     blocked_url_paths_.clear();
+    page_committed_at_ = base::TimeTicks::Now();
   }
 
   navigation_handle->GetWebContents()->SendToAllFrames(
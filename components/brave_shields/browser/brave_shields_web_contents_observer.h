@@ -6,14 +6,14 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_BRAVE_SHIELDS_WEB_CONTENTS_OBSERVER_H_
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_BRAVE_SHIELDS_WEB_CONTENTS_OBSERVER_H_
 
-#include <map>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "base/macros.h"
-#include "base/synchronization/lock.h"
 #include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "brave/components/brave_shields/browser/frame_tab_url_map.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
 
@@ -25,6 +25,18 @@ class PrefRegistrySimple;
 
 namespace brave_shields {
 
+// A resource blocked on the IO thread, on its way to the UI thread.
+struct BlockedEvent {
+  std::string block_type;
+  std::string subresource;
+  int render_process_id;
+  int render_frame_id;
+  int frame_tree_node_id;
+  // Events raised before the tab's current page committed belong to the
+  // previous page and are dropped.
+  base::TimeTicks raised_at;
+};
+
 class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
     public content::WebContentsUserData<BraveShieldsWebContentsObserver> {
  public:
@@ -36,35 +48,18 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
       const std::string& block_type,
       const std::string& subresource,
       content::WebContents* web_contents);
-  static void DispatchBlockedEvent(
-      std::string block_type,
-      std::string subresource,
+  static void DispatchBlockedEvents(std::vector<BlockedEvent> events);
+  // Only called on the IO thread.
+  static const GURL& GetTabURLFromRenderFrameInfo(
       int render_process_id,
-      int render_frame_id, int frame_tree_node_id);
-  static GURL GetTabURLFromRenderFrameInfo(int render_process_id,
-                                           int render_frame_id,
-                                           int render_frame_tree_node_id);
+      int render_frame_id,
+      int render_frame_tree_node_id);
   void AllowScriptsOnce(const std::vector<std::string>& origins,
                         content::WebContents* web_contents);
   bool IsBlockedSubresource(const std::string& subresource);
   void AddBlockedSubresource(const std::string& subresource);
 
  protected:
-    // A set of identifiers that uniquely identifies a RenderFrame.
-  struct RenderFrameIdKey {
-    RenderFrameIdKey();
-    RenderFrameIdKey(int render_process_id, int frame_routing_id);
-
-    // The process ID of the renderer that contains the RenderFrame.
-    int render_process_id;
-
-    // The routing ID of the RenderFrame.
-    int frame_routing_id;
-
-    bool operator<(const RenderFrameIdKey& other) const;
-    bool operator==(const RenderFrameIdKey& other) const;
-  };
-
   // content::WebContentsObserver overrides.
   void RenderFrameCreated(content::RenderFrameHost* host) override;
   void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
@@ -74,6 +69,8 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
       content::NavigationHandle* navigation_handle) override;
   void DidFinishNavigation(
       content::NavigationHandle* navigation_handle) override;
+  void DidFinishLoad(content::RenderFrameHost* render_frame_host,
+                     const GURL& validated_url) override;
 
   // Invoked if an IPC message is coming from a specific RenderFrameHost.
   bool OnMessageReceived(const IPC::Message& message,
@@ -85,19 +82,24 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
       content::RenderFrameHost* render_frame_host,
       const base::string16& details);
 
-  // TODO(iefremov): Refactor this away or at least put into base::NoDestructor.
-  // Protects global maps below from being concurrently written on the UI thread
-  // and read on the IO thread.
-  static base::Lock frame_data_map_lock_;
-  static std::map<RenderFrameIdKey, GURL> frame_key_to_tab_url_;
-  static std::map<int, GURL> frame_tree_node_id_to_tab_url_;
-
  private:
   friend class content::WebContentsUserData<BraveShieldsWebContentsObserver>;
+
+  // Returns the snapshot of the current tab URL handed to FrameTabURLMap,
+  // making a new one only when the URL has changed.
+  scoped_refptr<const TabURL> GetTabURLSnapshot();
+  // Per-tab frame state, set up when a frame is created or swapped in.
+  void SetUpFrame(content::RenderFrameHost* rfh);
+  void TearDownFrame(content::RenderFrameHost* rfh);
+
+  scoped_refptr<const TabURL> tab_url_;
   std::vector<std::string> allowed_script_origins_;
   // We keep a set of the current page's blocked URLs in case the page
   // continually tries to load the same blocked URLs.
   std::set<std::string> blocked_url_paths_;
+  // When the current page started committing, which is when
+  // |blocked_url_paths_| was last cleared.
+  base::TimeTicks page_committed_at_;
 
   WEB_CONTENTS_USER_DATA_KEY_DECL();
   DISALLOW_COPY_AND_ASSIGN(BraveShieldsWebContentsObserver);
@@ -0,0 +1,86 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "brave/common/pref_names.h"
+#include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "chrome/test/base/chrome_render_view_host_test_harness.h"
+#include "components/prefs/pref_service.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using brave_shields::BlockedEvent;
+using brave_shields::BraveShieldsWebContentsObserver;
+
+class BraveShieldsWebContentsObserverTest
+    : public ChromeRenderViewHostTestHarness {
+ public:
+  BraveShieldsWebContentsObserverTest() = default;
+  ~BraveShieldsWebContentsObserverTest() override = default;
+
+  void SetUp() override {
+    ChromeRenderViewHostTestHarness::SetUp();
+    BraveShieldsWebContentsObserver::CreateForWebContents(web_contents());
+  }
+
+  BraveShieldsWebContentsObserver* observer() {
+    return BraveShieldsWebContentsObserver::FromWebContents(web_contents());
+  }
+
+  BlockedEvent CreateBlockedEvent(const std::string& subresource,
+                                  base::TimeTicks raised_at) {
+    return BlockedEvent{brave_shields::kAds, subresource,
+                        main_rfh()->GetProcess()->GetID(),
+                        main_rfh()->GetRoutingID(),
+                        main_rfh()->GetFrameTreeNodeId(), raised_at};
+  }
+
+  uint64_t GetAdsBlocked() {
+    return profile()->GetPrefs()->GetUint64(kAdsBlocked);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(BraveShieldsWebContentsObserverTest);
+};
+
+TEST_F(BraveShieldsWebContentsObserverTest, DropsEventsOfPreviousPage) {
+  NavigateAndCommit(GURL("https://brave.com"));
+
+  // Raised by the first page, but still batched when the next one commits.
+  std::vector<BlockedEvent> events;
+  events.push_back(CreateBlockedEvent(
+      "https://ads.com/old.js",
+      base::TimeTicks::Now() - base::TimeDelta::FromMilliseconds(1)));
+  NavigateAndCommit(GURL("https://example.com"));
+  events.push_back(CreateBlockedEvent("https://ads.com/new.js",
+                                      base::TimeTicks::Now()));
+
+  BraveShieldsWebContentsObserver::DispatchBlockedEvents(std::move(events));
+  EXPECT_FALSE(observer()->IsBlockedSubresource("https://ads.com/old.js"));
+  EXPECT_TRUE(observer()->IsBlockedSubresource("https://ads.com/new.js"));
+  EXPECT_EQ(GetAdsBlocked(), 1u);
+}
+
+TEST_F(BraveShieldsWebContentsObserverTest, CountsEachResourceOncePerPage) {
+  NavigateAndCommit(GURL("https://brave.com"));
+
+  std::vector<BlockedEvent> events;
+  events.push_back(CreateBlockedEvent("https://ads.com/ad.js",
+                                      base::TimeTicks::Now()));
+  events.push_back(CreateBlockedEvent("https://ads.com/ad.js",
+                                      base::TimeTicks::Now()));
+  BraveShieldsWebContentsObserver::DispatchBlockedEvents(std::move(events));
+  EXPECT_TRUE(observer()->IsBlockedSubresource("https://ads.com/ad.js"));
+  EXPECT_EQ(GetAdsBlocked(), 1u);
+}
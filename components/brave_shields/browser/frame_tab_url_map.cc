@@ -0,0 +1,72 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/frame_tab_url_map.h"
+
+#include <utility>
+
+#include "base/no_destructor.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace brave_shields {
+
+FrameTabURLMap::FrameTabURLMap() {}
+
+FrameTabURLMap::~FrameTabURLMap() {}
+
+// static
+FrameTabURLMap* FrameTabURLMap::GetInstance() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  static base::NoDestructor<FrameTabURLMap> instance;
+  return instance.get();
+}
+
+// static
+uint64_t FrameTabURLMap::GetFrameKey(int render_process_id,
+                                     int render_frame_id) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(render_process_id))
+          << 32) |
+         static_cast<uint32_t>(render_frame_id);
+}
+
+void FrameTabURLMap::SetTabURL(int render_process_id,
+                               int render_frame_id,
+                               int frame_tree_node_id,
+                               scoped_refptr<const TabURL> tab_url) {
+  frame_key_to_tab_url_[GetFrameKey(render_process_id, render_frame_id)] =
+      tab_url;
+  frame_tree_node_id_to_tab_url_[frame_tree_node_id] = std::move(tab_url);
+}
+
+void FrameTabURLMap::RemoveFrame(int render_process_id,
+                                 int render_frame_id,
+                                 int frame_tree_node_id) {
+  frame_key_to_tab_url_.erase(GetFrameKey(render_process_id, render_frame_id));
+  frame_tree_node_id_to_tab_url_.erase(frame_tree_node_id);
+}
+
+const GURL& FrameTabURLMap::GetTabURL(int render_process_id,
+                                      int render_frame_id,
+                                      int frame_tree_node_id) const {
+  if (-1 != render_process_id && -1 != render_frame_id) {
+    auto iter = frame_key_to_tab_url_.find(
+        GetFrameKey(render_process_id, render_frame_id));
+    if (iter != frame_key_to_tab_url_.end()) {
+      return iter->second->data;
+    }
+  }
+  if (-1 != frame_tree_node_id) {
+    auto iter = frame_tree_node_id_to_tab_url_.find(frame_tree_node_id);
+    if (iter != frame_tree_node_id_to_tab_url_.end()) {
+      return iter->second->data;
+    }
+  }
+  static const base::NoDestructor<GURL> empty_url;
+  return *empty_url;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,65 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_FRAME_TAB_URL_MAP_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_FRAME_TAB_URL_MAP_H_
+
+#include <stdint.h>
+
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+// An immutable copy of a tab's URL. It's created on the UI thread and shared
+// by every frame entry of the tab, so frames don't each hold a GURL copy.
+using TabURL = base::RefCountedData<GURL>;
+
+// Maps render frames, by (process id, routing id) or by frame tree node id,
+// to the URL of the tab they belong to.
+//
+// Only used on the IO thread, so requests look up their tab without taking
+// a lock. The UI thread posts its frame updates here, in order.
+class FrameTabURLMap {
+ public:
+  FrameTabURLMap();
+  ~FrameTabURLMap();
+
+  // The map kept up to date by BraveShieldsWebContentsObserver.
+  static FrameTabURLMap* GetInstance();
+
+  void SetTabURL(int render_process_id,
+                 int render_frame_id,
+                 int frame_tree_node_id,
+                 scoped_refptr<const TabURL> tab_url);
+  void RemoveFrame(int render_process_id,
+                   int render_frame_id,
+                   int frame_tree_node_id);
+
+  // Returns an empty GURL for unknown frames. Pass -1 for ids that aren't
+  // known. The reference stays valid until the map is next updated.
+  const GURL& GetTabURL(int render_process_id,
+                        int render_frame_id,
+                        int frame_tree_node_id) const;
+
+  size_t frame_count() const { return frame_key_to_tab_url_.size(); }
+
+ private:
+  static uint64_t GetFrameKey(int render_process_id, int render_frame_id);
+
+  std::unordered_map<uint64_t, scoped_refptr<const TabURL>>
+      frame_key_to_tab_url_;
+  std::unordered_map<int, scoped_refptr<const TabURL>>
+      frame_tree_node_id_to_tab_url_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameTabURLMap);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_FRAME_TAB_URL_MAP_H_
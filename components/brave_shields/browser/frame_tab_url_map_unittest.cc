@@ -0,0 +1,136 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/frame_tab_url_map.h"
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+const int kTabCount = 300;
+const int kFramesPerTab = 20;
+
+// Frame ids of tab |tab| as the UI thread would report them. Every tab has
+// its own renderer process and frame tree node ids are unique per browser.
+int ProcessId(int tab) {
+  return tab + 1;
+}
+
+int RoutingId(int frame) {
+  return frame + 1;
+}
+
+int FrameTreeNodeId(int tab, int frame) {
+  return tab * kFramesPerTab + frame + 1;
+}
+
+GURL NavigationURL(int tab, int navigation) {
+  return GURL("https://tab" + base::NumberToString(tab) + ".example.com/" +
+              base::NumberToString(navigation));
+}
+
+}  // namespace
+
+TEST(FrameTabURLMapTest, UnknownFrame) {
+  FrameTabURLMap map;
+  EXPECT_TRUE(map.GetTabURL(1, 1, 1).is_empty());
+  EXPECT_TRUE(map.GetTabURL(-1, -1, -1).is_empty());
+
+  map.SetTabURL(1, 1, 1,
+                base::MakeRefCounted<TabURL>(GURL("https://brave.com")));
+  EXPECT_TRUE(map.GetTabURL(1, 2, -1).is_empty());
+  EXPECT_TRUE(map.GetTabURL(2, 1, -1).is_empty());
+  EXPECT_TRUE(map.GetTabURL(-1, -1, 2).is_empty());
+  EXPECT_EQ(GURL("https://brave.com"), map.GetTabURL(-1, -1, 1));
+  EXPECT_EQ(GURL("https://brave.com"), map.GetTabURL(1, 1, -1));
+}
+
+TEST(FrameTabURLMapTest, FallsBackToFrameTreeNodeId) {
+  FrameTabURLMap map;
+  map.SetTabURL(1, 1, 5,
+                base::MakeRefCounted<TabURL>(GURL("https://brave.com")));
+  map.SetTabURL(2, 7, 6,
+                base::MakeRefCounted<TabURL>(GURL("https://example.com")));
+  // A known frame key wins over the frame tree node id.
+  EXPECT_EQ(GURL("https://brave.com"), map.GetTabURL(1, 1, 6));
+  EXPECT_EQ(GURL("https://example.com"), map.GetTabURL(1, 2, 6));
+
+  map.RemoveFrame(1, 1, 5);
+  EXPECT_TRUE(map.GetTabURL(1, 1, 5).is_empty());
+  EXPECT_EQ(1u, map.frame_count());
+}
+
+// Many tabs with many frames each, navigated and closed in turn, the way the
+// UI thread updates the map while the IO thread keeps reading it.
+TEST(FrameTabURLMapTest, ManyTabsAndFrames) {
+  FrameTabURLMap map;
+  std::vector<scoped_refptr<const TabURL>> snapshots;
+  for (int tab = 0; tab < kTabCount; ++tab) {
+    snapshots.push_back(
+        base::MakeRefCounted<TabURL>(NavigationURL(tab, 0)));
+    for (int frame = 0; frame < kFramesPerTab; ++frame) {
+      map.SetTabURL(ProcessId(tab), RoutingId(frame),
+                    FrameTreeNodeId(tab, frame), snapshots[tab]);
+    }
+  }
+  EXPECT_EQ(static_cast<size_t>(kTabCount * kFramesPerTab),
+            map.frame_count());
+
+  // Every frame of a tab shares the tab's snapshot.
+  for (int tab = 0; tab < kTabCount; ++tab) {
+    for (int frame = 0; frame < kFramesPerTab; ++frame) {
+      EXPECT_EQ(&snapshots[tab]->data,
+                &map.GetTabURL(ProcessId(tab), RoutingId(frame), -1));
+      EXPECT_EQ(&snapshots[tab]->data,
+                &map.GetTabURL(-1, -1, FrameTreeNodeId(tab, frame)));
+    }
+  }
+
+  // Navigate the main frame of every other tab and close every third tab.
+  for (int tab = 0; tab < kTabCount; ++tab) {
+    if (tab % 3 == 0) {
+      for (int frame = 0; frame < kFramesPerTab; ++frame) {
+        map.RemoveFrame(ProcessId(tab), RoutingId(frame),
+                        FrameTreeNodeId(tab, frame));
+      }
+    } else if (tab % 2 == 0) {
+      map.SetTabURL(ProcessId(tab), RoutingId(0), FrameTreeNodeId(tab, 0),
+                    base::MakeRefCounted<TabURL>(NavigationURL(tab, 1)));
+    }
+  }
+
+  for (int tab = 0; tab < kTabCount; ++tab) {
+    for (int frame = 0; frame < kFramesPerTab; ++frame) {
+      const GURL& url =
+          map.GetTabURL(ProcessId(tab), RoutingId(frame),
+                        FrameTreeNodeId(tab, frame));
+      if (tab % 3 == 0) {
+        EXPECT_TRUE(url.is_empty());
+      } else if (tab % 2 == 0 && frame == 0) {
+        EXPECT_EQ(NavigationURL(tab, 1), url);
+      } else {
+        EXPECT_EQ(NavigationURL(tab, 0), url);
+      }
+    }
+  }
+
+  // Dropping the map's references leaves the test as the only owner.
+  for (int tab = 0; tab < kTabCount; ++tab) {
+    for (int frame = 0; frame < kFramesPerTab; ++frame) {
+      map.RemoveFrame(ProcessId(tab), RoutingId(frame),
+                      FrameTreeNodeId(tab, frame));
+    }
+    EXPECT_TRUE(snapshots[tab]->HasOneRef());
+  }
+  EXPECT_EQ(0u, map.frame_count());
+}
+
+}  // namespace brave_shields
@@ -28,3 +28,20 @@ TEST(HTTPSEverywhereRecentlyUsedCacheTest, Operations) {
   cache.remove("kD");
   ASSERT_FALSE(cache.get("kD", &v));
 }
+
+TEST(HTTPSEverywhereRecentlyUsedCacheTest, Shards) {
+  using Cache = HTTPSERecentlyUsedCache<std::string>;
+  Cache cache(64, 4);
+
+  for (int i = 0; i < 16; i++) {
+    cache.add("k" + std::to_string(i), "v" + std::to_string(i));
+  }
+  std::string v;
+  for (int i = 0; i < 16; i++) {
+    ASSERT_TRUE(cache.get("k" + std::to_string(i), &v));
+    EXPECT_EQ(v, "v" + std::to_string(i));
+  }
+
+  cache.clear();
+  ASSERT_FALSE(cache.get("k0", &v));
+}
@@ -0,0 +1,50 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_redirect_counter.h"
+
+#include "base/logging.h"
+
+namespace brave_shields {
+
+HTTPSERedirectCounter::HTTPSERedirectCounter(size_t max_requests,
+                                             unsigned int max_redirects)
+    : max_redirects_(max_redirects), redirects_(max_requests) {
+  DCHECK_GT(max_requests, 0u);
+}
+
+HTTPSERedirectCounter::~HTTPSERedirectCounter() {}
+
+bool HTTPSERedirectCounter::ShouldRedirect(uint64_t request_identifier) {
+  base::AutoLock auto_lock(lock_);
+  auto it = redirects_.Peek(request_identifier);
+  return it == redirects_.end() || it->second < max_redirects_ - 1;
+}
+
+void HTTPSERedirectCounter::AddRedirect(uint64_t request_identifier) {
+  base::AutoLock auto_lock(lock_);
+  auto it = redirects_.Peek(request_identifier);
+  if (it != redirects_.end()) {
+    it->second++;
+    return;
+  }
+
+  // The request is new. If the cache is full, Put() forgets the oldest one.
+  redirects_.Put(request_identifier, 1);
+}
+
+void HTTPSERedirectCounter::Remove(uint64_t request_identifier) {
+  base::AutoLock auto_lock(lock_);
+  auto it = redirects_.Peek(request_identifier);
+  if (it != redirects_.end())
+    redirects_.Erase(it);
+}
+
+size_t HTTPSERedirectCounter::size() {
+  base::AutoLock auto_lock(lock_);
+  return redirects_.size();
+}
+
+}  // namespace brave_shields
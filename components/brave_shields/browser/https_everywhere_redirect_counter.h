@@ -0,0 +1,45 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_REDIRECT_COUNTER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_REDIRECT_COUNTER_H_
+
+#include <stdint.h>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+
+namespace brave_shields {
+
+// Counts the HTTPS Everywhere redirects of each in-flight request, so that
+// redirect loops can be cut off. Lookup, increment and removal are O(1).
+// At most |max_requests| requests are tracked; beyond that the oldest one is
+// forgotten. Requests are normally removed when they are destroyed.
+class HTTPSERedirectCounter {
+ public:
+  HTTPSERedirectCounter(size_t max_requests, unsigned int max_redirects);
+  ~HTTPSERedirectCounter();
+
+  // Returns false once |request_identifier| used up its redirects.
+  bool ShouldRedirect(uint64_t request_identifier);
+  void AddRedirect(uint64_t request_identifier);
+  void Remove(uint64_t request_identifier);
+  size_t size();
+
+ private:
+  const unsigned int max_redirects_;
+  base::Lock lock_;
+  // Redirect counts keyed by request identifier, in insertion order. Entries
+  // are only read with Peek() so that the order is never refreshed, and the
+  // cache evicts the oldest request once it holds |max_requests| of them.
+  base::HashingMRUCache<uint64_t, unsigned int> redirects_;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSERedirectCounter);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_REDIRECT_COUNTER_H_
@@ -0,0 +1,89 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_redirect_counter.h"
+
+#include "base/logging.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_shields::HTTPSERedirectCounter;
+
+TEST(HTTPSEverywhereRedirectCounterTest, MaxRedirects) {
+  HTTPSERedirectCounter counter(10, 5);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(counter.ShouldRedirect(1));
+    counter.AddRedirect(1);
+  }
+  EXPECT_FALSE(counter.ShouldRedirect(1));
+  EXPECT_TRUE(counter.ShouldRedirect(2));
+
+  counter.Remove(1);
+  EXPECT_TRUE(counter.ShouldRedirect(1));
+  EXPECT_EQ(counter.size(), 0u);
+}
+
+TEST(HTTPSEverywhereRedirectCounterTest, EvictsOldest) {
+  HTTPSERedirectCounter counter(2, 2);
+  counter.AddRedirect(1);
+  counter.AddRedirect(2);
+  EXPECT_FALSE(counter.ShouldRedirect(1));
+  counter.AddRedirect(3);
+  EXPECT_EQ(counter.size(), 2u);
+  // Request 1 was forgotten to make room for request 3.
+  EXPECT_TRUE(counter.ShouldRedirect(1));
+  EXPECT_FALSE(counter.ShouldRedirect(2));
+  EXPECT_FALSE(counter.ShouldRedirect(3));
+}
+
+TEST(HTTPSEverywhereRedirectCounterTest, RemovedRequestsFreeRoom) {
+  HTTPSERedirectCounter counter(2, 2);
+  counter.AddRedirect(1);
+  counter.AddRedirect(2);
+  counter.Remove(1);
+  counter.AddRedirect(3);
+  EXPECT_FALSE(counter.ShouldRedirect(2));
+  EXPECT_FALSE(counter.ShouldRedirect(3));
+}
+
+TEST(HTTPSEverywhereRedirectCounterTest, RemovedFromMiddleFreesRoom) {
+  HTTPSERedirectCounter counter(3, 3);
+  counter.AddRedirect(1);
+  counter.AddRedirect(2);
+  counter.AddRedirect(3);
+  counter.AddRedirect(1);
+  counter.Remove(2);
+  counter.AddRedirect(4);
+  EXPECT_EQ(counter.size(), 3u);
+  // The long-lived request 1 keeps its count.
+  EXPECT_FALSE(counter.ShouldRedirect(1));
+  EXPECT_TRUE(counter.ShouldRedirect(3));
+  EXPECT_TRUE(counter.ShouldRedirect(4));
+}
+
+// Simulates many concurrent requests, each upgraded once and then destroyed
+// in a different order than they were created.
+TEST(HTTPSEverywhereRedirectCounterTest, ManyConcurrentRequests) {
+  const uint64_t kRequests = 20000;
+  const uint64_t kInFlight = 2000;
+  HTTPSERedirectCounter counter(kInFlight, 5);
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (uint64_t id = 1; id <= kRequests; id++) {
+    EXPECT_TRUE(counter.ShouldRedirect(id));
+    counter.AddRedirect(id);
+    if (id > kInFlight / 2) {
+      // Destroy an older request, alternating between the oldest and a more
+      // recent one.
+      uint64_t done = (id % 2) ? id - kInFlight / 2 : id - kInFlight / 4;
+      counter.Remove(done);
+    }
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  LOG(INFO) << kRequests << " requests accounted in "
+            << elapsed.InMicroseconds() << "us";
+
+  EXPECT_LE(counter.size(), kInFlight);
+}
@@ -0,0 +1,154 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rules.h"
+
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/values.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace brave_shields {
+
+HTTPSERules::Rule::Rule() {}
+
+HTTPSERules::Rule::Rule(Rule&& other) = default;
+
+HTTPSERules::Rule::~Rule() {}
+
+HTTPSERules::RuleSet::RuleSet() {}
+
+HTTPSERules::RuleSet::RuleSet(RuleSet&& other) = default;
+
+HTTPSERules::RuleSet::~RuleSet() {}
+
+HTTPSERules::HTTPSERules() {}
+
+HTTPSERules::~HTTPSERules() {}
+
+// static
+std::unique_ptr<HTTPSERules> HTTPSERules::Parse(const std::string& json) {
+  base::Optional<base::Value> json_object = base::JSONReader::Read(json);
+  if (base::nullopt == json_object || !json_object->is_list()) {
+    return nullptr;
+  }
+
+  std::unique_ptr<HTTPSERules> rules(new HTTPSERules());
+  for (const auto& top_value : json_object->GetList()) {
+    if (!top_value.is_dict()) {
+      continue;
+    }
+
+    RuleSet rule_set;
+    const base::Value* exclusions = top_value.FindKeyOfType(
+        "e", base::Value::Type::LIST);
+    if (exclusions) {
+      for (const auto& exclusion : exclusions->GetList()) {
+        if (!exclusion.is_dict()) {
+          continue;
+        }
+        const base::Value* pattern = exclusion.FindKeyOfType(
+            "p", base::Value::Type::STRING);
+        if (!pattern) {
+          continue;
+        }
+        auto exclusion_re = std::make_unique<re2::RE2>(
+            CorrecttoRuleToRE2Engine(pattern->GetString()));
+        if (exclusion_re->ok()) {
+          rule_set.exclusions.push_back(std::move(exclusion_re));
+        }
+      }
+    }
+
+    const base::Value* rule_values = top_value.FindKeyOfType(
+        "r", base::Value::Type::LIST);
+    if (rule_values) {
+      rule_set.has_rules = true;
+      for (const auto& rule_value : rule_values->GetList()) {
+        if (!rule_value.is_dict()) {
+          continue;
+        }
+        Rule rule;
+        if (rule_value.FindKey("d")) {
+          rule.upgrade_scheme = true;
+          rule_set.rules.push_back(std::move(rule));
+          continue;
+        }
+        const base::Value* from = rule_value.FindKeyOfType(
+            "f", base::Value::Type::STRING);
+        const base::Value* to = rule_value.FindKeyOfType(
+            "t", base::Value::Type::STRING);
+        if (!from || !to) {
+          continue;
+        }
+        rule.from = std::make_unique<re2::RE2>(from->GetString());
+        if (!rule.from->ok()) {
+          continue;
+        }
+        rule.to = CorrecttoRuleToRE2Engine(to->GetString());
+        rule_set.rules.push_back(std::move(rule));
+      }
+    }
+
+    rules->rule_sets_.push_back(std::move(rule_set));
+    // Nothing after a rule set without rules is ever consulted.
+    if (!rules->rule_sets_.back().has_rules) {
+      break;
+    }
+  }
+
+  return rules;
+}
+
+std::string HTTPSERules::Apply(const std::string& original_url) const {
+  for (const auto& rule_set : rule_sets_) {
+    for (const auto& exclusion : rule_set.exclusions) {
+      if (re2::RE2::FullMatch(original_url, *exclusion)) {
+        return "";
+      }
+    }
+
+    if (!rule_set.has_rules) {
+      return "";
+    }
+
+    for (const auto& rule : rule_set.rules) {
+      if (rule.upgrade_scheme) {
+        std::string new_url(original_url);
+        return new_url.insert(4, "s");
+      }
+
+      std::string new_url(original_url);
+      if (re2::RE2::Replace(&new_url, *rule.from, rule.to) &&
+          new_url != original_url) {
+        return new_url;
+      }
+    }
+  }
+  return "";
+}
+
+bool HTTPSERules::UpgradesEveryURL() const {
+  if (rule_sets_.empty()) {
+    return false;
+  }
+  const RuleSet& rule_set = rule_sets_.front();
+  return rule_set.exclusions.empty() && !rule_set.rules.empty() &&
+         rule_set.rules.front().upgrade_scheme;
+}
+
+std::string CorrecttoRuleToRE2Engine(const std::string& to) {
+  std::string correctedto(to);
+  size_t pos = to.find("$");
+  while (std::string::npos != pos) {
+    correctedto[pos] = '\\';
+    pos = correctedto.find("$");
+  }
+
+  return correctedto;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,74 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULES_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULES_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace re2 {
+class RE2;
+}  // namespace re2
+
+namespace brave_shields {
+
+// The compiled form of the HTTPS Everywhere rule sets stored in the leveldb
+// value for one lookup domain. The JSON is parsed and every regular
+// expression is built once, so applying the rules to a URL does no parsing.
+class HTTPSERules {
+ public:
+  ~HTTPSERules();
+
+  // Returns nullptr if |json| is not a list of rule sets.
+  static std::unique_ptr<HTTPSERules> Parse(const std::string& json);
+
+  // Returns the upgraded URL, or an empty string if no rule applies.
+  std::string Apply(const std::string& original_url) const;
+
+  // Returns true if the rules upgrade every URL they are consulted for,
+  // i.e. the first rule set has no exclusions and starts with a plain
+  // scheme upgrade. The result for such rules only depends on the host.
+  bool UpgradesEveryURL() const;
+
+ private:
+  struct Rule {
+    Rule();
+    Rule(Rule&& other);
+    ~Rule();
+
+    // A rule with the "d" key upgrades any URL of the rule set.
+    bool upgrade_scheme = false;
+    std::unique_ptr<re2::RE2> from;
+    std::string to;
+  };
+
+  struct RuleSet {
+    RuleSet();
+    RuleSet(RuleSet&& other);
+    ~RuleSet();
+
+    std::vector<std::unique_ptr<re2::RE2>> exclusions;
+    // A rule set without a valid "r" list ends the lookup.
+    bool has_rules = false;
+    std::vector<Rule> rules;
+  };
+
+  HTTPSERules();
+
+  std::vector<RuleSet> rule_sets_;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSERules);
+};
+
+// HTTPS Everywhere rules use $1 style back references, RE2 uses \1.
+std::string CorrecttoRuleToRE2Engine(const std::string& to);
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULES_H_
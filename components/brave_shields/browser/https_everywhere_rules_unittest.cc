@@ -0,0 +1,71 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+
+#include "brave/components/brave_shields/browser/https_everywhere_rules.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_shields::HTTPSERules;
+
+TEST(HTTPSEverywhereRulesTest, InvalidJSON) {
+  EXPECT_FALSE(HTTPSERules::Parse("not json"));
+  EXPECT_FALSE(HTTPSERules::Parse("{\"r\": []}"));
+}
+
+TEST(HTTPSEverywhereRulesTest, UpgradeScheme) {
+  std::unique_ptr<HTTPSERules> rules =
+      HTTPSERules::Parse("[{\"r\": [{\"d\": 1}]}]");
+  ASSERT_TRUE(rules);
+  EXPECT_EQ(rules->Apply("http://www.brave.com/"), "https://www.brave.com/");
+}
+
+TEST(HTTPSEverywhereRulesTest, FromTo) {
+  std::unique_ptr<HTTPSERules> rules = HTTPSERules::Parse(
+      "[{\"r\": [{\"f\": \"^http://(www\\\\.)?brave\\\\.com/\","
+      " \"t\": \"https://$1brave.com/\"}]}]");
+  ASSERT_TRUE(rules);
+  EXPECT_EQ(rules->Apply("http://www.brave.com/download"),
+            "https://www.brave.com/download");
+  EXPECT_EQ(rules->Apply("http://brave.com/"), "https://brave.com/");
+  EXPECT_EQ(rules->Apply("http://example.com/"), "");
+  // Applying the same compiled rules again gives the same result.
+  EXPECT_EQ(rules->Apply("http://brave.com/"), "https://brave.com/");
+}
+
+TEST(HTTPSEverywhereRulesTest, Exclusions) {
+  std::unique_ptr<HTTPSERules> rules = HTTPSERules::Parse(
+      "[{\"e\": [{\"p\": \"^http://www\\\\.brave\\\\.com/insecure.*\"}],"
+      " \"r\": [{\"d\": 1}]}]");
+  ASSERT_TRUE(rules);
+  EXPECT_EQ(rules->Apply("http://www.brave.com/insecure/page"), "");
+  EXPECT_EQ(rules->Apply("http://www.brave.com/secure"),
+            "https://www.brave.com/secure");
+}
+
+TEST(HTTPSEverywhereRulesTest, RuleSetWithoutRulesEndsLookup) {
+  std::unique_ptr<HTTPSERules> rules =
+      HTTPSERules::Parse("[{\"e\": []}, {\"r\": [{\"d\": 1}]}]");
+  ASSERT_TRUE(rules);
+  EXPECT_EQ(rules->Apply("http://www.brave.com/"), "");
+}
+
+TEST(HTTPSEverywhereRulesTest, CorrectBackReferences) {
+  EXPECT_EQ(brave_shields::CorrecttoRuleToRE2Engine("https://$1.$2/"),
+            "https://\\1.\\2/");
+}
+
+TEST(HTTPSEverywhereRulesTest, UpgradesEveryURL) {
+  EXPECT_TRUE(HTTPSERules::Parse("[{\"r\": [{\"d\": 1}]}]")
+                  ->UpgradesEveryURL());
+  EXPECT_FALSE(HTTPSERules::Parse(
+      "[{\"e\": [{\"p\": \"^http://a\\\\.com/x\"}], \"r\": [{\"d\": 1}]}]")
+                   ->UpgradesEveryURL());
+  EXPECT_FALSE(HTTPSERules::Parse(
+      "[{\"r\": [{\"f\": \"^http://a\\\\.com/\", \"t\": \"https://a.com/\"}]}]")
+                   ->UpgradesEveryURL());
+  EXPECT_FALSE(HTTPSERules::Parse("[]")->UpgradesEveryURL());
+}
@@ -12,21 +12,22 @@
 
 #include "base/base_paths.h"
 #include "base/bind.h"
-#include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
-#include "base/values.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
-#include "third_party/re2/src/re2/re2.h"
 #include "third_party/zlib/google/zip.h"
 
 #define DAT_FILE "httpse.leveldb.zip"
 #define DAT_FILE_VERSION "6.0"
-#define HTTPSE_URLS_REDIRECTS_COUNT_QUEUE   1
+#define HTTPSE_URLS_REDIRECTS_COUNT_QUEUE   1000
 #define HTTPSE_URL_MAX_REDIRECTS_COUNT      5
+#define HTTPSE_COMPILED_RULES_CACHE_SIZE    1000
+#define HTTPSE_RECENTLY_USED_CACHE_SIZE     1024
+#define HTTPSE_RECENTLY_USED_HOSTS_CACHE_SIZE 512
+#define HTTPSE_RECENTLY_USED_CACHE_SHARDS   8
 
 namespace {
 
@@ -100,6 +101,13 @@ HTTPSEverywhereService::g_https_everywhere_component_base64_public_key_(
 HTTPSEverywhereService::HTTPSEverywhereService(
     BraveComponent::Delegate* delegate)
     : BaseBraveShieldsService(delegate),
+      httpse_urls_redirects_count_(HTTPSE_URLS_REDIRECTS_COUNT_QUEUE,
+                                   HTTPSE_URL_MAX_REDIRECTS_COUNT),
+      recently_used_cache_(HTTPSE_RECENTLY_USED_CACHE_SIZE,
+                           HTTPSE_RECENTLY_USED_CACHE_SHARDS),
+      recently_used_hosts_cache_(HTTPSE_RECENTLY_USED_HOSTS_CACHE_SIZE,
+                                 HTTPSE_RECENTLY_USED_CACHE_SHARDS),
+      compiled_rules_cache_(HTTPSE_COMPILED_RULES_CACHE_SIZE),
       level_db_(nullptr) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
@@ -178,29 +186,29 @@ bool HTTPSEverywhereService::GetHTTPSURL(
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), new_url)) {
+  GURL candidate_url = GetCandidateURL(*url);
+  if (GetHTTPSURLFromCache(candidate_url, new_url)) {
     AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
 
-  GURL candidate_url(*url);
-  if (g_ignore_port_for_test_ && candidate_url.has_port()) {
-    GURL::Replacements replacements;
-    replacements.ClearPort();
-    candidate_url = candidate_url.ReplaceComponents(replacements);
-  }
-
   const std::vector<std::string> domains =
       ExpandDomainForLookup(candidate_url.host());
-  for (auto domain : domains) {
-    std::string value = leveldbGet(level_db_, domain);
-    if (!value.empty()) {
-      *new_url = ApplyHTTPSRule(candidate_url.spec(), value);
+  bool found_rules = false;
+  for (const auto& domain : domains) {
+    const HTTPSERules* rules = GetRulesForDomain(domain);
+    if (rules) {
+      *new_url = rules->Apply(candidate_url.spec());
       if (0 != new_url->length()) {
         recently_used_cache_.add(candidate_url.spec(), *new_url);
+        // Only the most specific rules for the host decide every URL on it.
+        if (!found_rules && rules->UpgradesEveryURL()) {
+          recently_used_hosts_cache_.add(candidate_url.host(), true);
+        }
         AddHTTPSEUrlToRedirectList(request_identifier);
         return true;
       }
+      found_rules = true;
     }
   }
   recently_used_cache_.remove(candidate_url.spec());
@@ -221,169 +229,75 @@ bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), cached_url)) {
+  if (GetHTTPSURLFromCache(GetCandidateURL(*url), cached_url)) {
     AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
   return false;
 }
 
-bool HTTPSEverywhereService::ShouldHTTPSERedirect(
-    const uint64_t& request_identifier) {
-  base::AutoLock auto_lock(httpse_get_urls_redirects_count_mutex_);
-  for (size_t i = 0; i < httpse_urls_redirects_count_.size(); i++) {
-    if (request_identifier ==
-        httpse_urls_redirects_count_[i].request_identifier_ &&
-        httpse_urls_redirects_count_[i].redirects_ >=
-        HTTPSE_URL_MAX_REDIRECTS_COUNT - 1) {
-      return false;
-    }
+// static
+GURL HTTPSEverywhereService::GetCandidateURL(const GURL& url) {
+  if (g_ignore_port_for_test_ && url.has_port()) {
+    GURL::Replacements replacements;
+    replacements.ClearPort();
+    return url.ReplaceComponents(replacements);
   }
-
-  return true;
+  return url;
 }
 
-void HTTPSEverywhereService::AddHTTPSEUrlToRedirectList(
-    const uint64_t& request_identifier) {
-  // Adding redirects count for the current request
-  base::AutoLock auto_lock(httpse_get_urls_redirects_count_mutex_);
-  bool hostFound = false;
-  for (size_t i = 0; i < httpse_urls_redirects_count_.size(); i++) {
-    if (request_identifier ==
-        httpse_urls_redirects_count_[i].request_identifier_) {
-      // Found the host, just increment the redirects_count
-      httpse_urls_redirects_count_[i].redirects_++;
-      hostFound = true;
-      break;
-    }
-  }
-  if (!hostFound) {
-      // The host is new, adding it to the redirects list
-      if (httpse_urls_redirects_count_.size() >=
-          HTTPSE_URLS_REDIRECTS_COUNT_QUEUE) {
-          // The queue is full, erase the first element
-          httpse_urls_redirects_count_.erase(
-              httpse_urls_redirects_count_.begin());
-      }
-      httpse_urls_redirects_count_.push_back(
-          HTTPSE_REDIRECTS_COUNT_ST(request_identifier, 1));
+bool HTTPSEverywhereService::GetHTTPSURLFromCache(const GURL& candidate_url,
+                                                  std::string* new_url) {
+  if (recently_used_cache_.get(candidate_url.spec(), new_url)) {
+    return true;
   }
-}
 
-std::string HTTPSEverywhereService::ApplyHTTPSRule(
-    const std::string& originalUrl,
-    const std::string& rule) {
-  base::Optional<base::Value> json_object = base::JSONReader::Read(rule);
-  if (base::nullopt == json_object || !json_object->is_list()) {
-    return "";
+  bool upgrades_every_url = false;
+  if (recently_used_hosts_cache_.get(candidate_url.host(),
+                                     &upgrades_every_url)) {
+    *new_url = candidate_url.spec();
+    new_url->insert(4, "s");
+    return true;
   }
+  return false;
+}
 
-  const base::Value::ListStorage& topValues = json_object->GetList();
-  for (auto it = topValues.cbegin(); it != topValues.cend(); ++it) {
-    if (!it->is_dict()) {
-      continue;
-    }
-    const base::DictionaryValue* childTopDictionary = nullptr;
-    it->GetAsDictionary(&childTopDictionary);
-    if (nullptr == childTopDictionary) {
-      continue;
-    }
-
-    const base::Value* exclusion = nullptr;
-    if (childTopDictionary->Get("e", &exclusion)) {
-      const base::ListValue* eValues = nullptr;
-      exclusion->GetAsList(&eValues);
-      if (nullptr != eValues) {
-        for (size_t j = 0; j < eValues->GetSize(); ++j) {
-          const base::Value* pValue = nullptr;
-          if (!eValues->Get(j, &pValue)) {
-            continue;
-          }
-          const base::DictionaryValue* pDictionary = nullptr;
-          pValue->GetAsDictionary(&pDictionary);
-          if (nullptr == pDictionary) {
-            continue;
-          }
-          const base::Value* patternValue = nullptr;
-          if (!pDictionary->Get("p", &patternValue)) {
-            continue;
-          }
-          std::string pattern;
-          if (!patternValue->GetAsString(&pattern)) {
-            continue;
-          }
-          pattern = CorrecttoRuleToRE2Engine(pattern);
-          if (RE2::FullMatch(originalUrl, pattern)) {
-            return "";
-          }
-        }
-      }
-    }
-
-    const base::Value* rules = nullptr;
-    if (!childTopDictionary->Get("r", &rules)) {
-      return "";
-    }
-    const base::ListValue* rValues = nullptr;
-    rules->GetAsList(&rValues);
-    if (nullptr == rValues) {
-      return "";
-    }
-
-    for (size_t j = 0; j < rValues->GetSize(); ++j) {
-      const base::Value* pValue = nullptr;
-      if (!rValues->Get(j, &pValue)) {
-        continue;
-      }
-      const base::DictionaryValue* pDictionary = nullptr;
-      pValue->GetAsDictionary(&pDictionary);
-      if (nullptr == pDictionary) {
-        continue;
-      }
-      const base::Value* patternValue = nullptr;
-      if (pDictionary->Get("d", &patternValue)) {
-        std::string newUrl(originalUrl);
-        return newUrl.insert(4, "s");
-      }
-
-      const base::Value* from_value = nullptr;
-      const base::Value* to_value = nullptr;
-      if (!pDictionary->Get("f", &from_value) ||
-          !pDictionary->Get("t", &to_value)) {
-        continue;
-      }
-      std::string from, to;
-      if (!from_value->GetAsString(&from) ||
-          !to_value->GetAsString(&to)) {
-        continue;
-      }
+bool HTTPSEverywhereService::ShouldHTTPSERedirect(
+    const uint64_t& request_identifier) {
+  return httpse_urls_redirects_count_.ShouldRedirect(request_identifier);
+}
 
-      to = CorrecttoRuleToRE2Engine(to);
-      std::string newUrl(originalUrl);
-      RE2 regExp(from);
+void HTTPSEverywhereService::AddHTTPSEUrlToRedirectList(
+    const uint64_t& request_identifier) {
+  // Adding redirects count for the current request
+  httpse_urls_redirects_count_.AddRedirect(request_identifier);
+}
 
-      if (RE2::Replace(&newUrl, regExp, to) && newUrl != originalUrl) {
-        return newUrl;
-      }
-    }
-  }
-  return "";
+void HTTPSEverywhereService::OnRequestDestroyed(uint64_t request_identifier) {
+  httpse_urls_redirects_count_.Remove(request_identifier);
 }
 
-std::string HTTPSEverywhereService::CorrecttoRuleToRE2Engine(
-    const std::string& to) {
-  std::string correctedto(to);
-  size_t pos = to.find("$");
-  while (std::string::npos != pos) {
-    correctedto[pos] = '\\';
-    pos = correctedto.find("$");
+const HTTPSERules* HTTPSEverywhereService::GetRulesForDomain(
+    const std::string& domain) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = compiled_rules_cache_.Get(domain);
+  if (it != compiled_rules_cache_.end()) {
+    return it->second.get();
   }
 
-  return correctedto;
+  std::unique_ptr<HTTPSERules> rules;
+  std::string value = leveldbGet(level_db_, domain);
+  if (!value.empty()) {
+    rules = HTTPSERules::Parse(value);
+  }
+  return compiled_rules_cache_.Put(domain, std::move(rules))->second.get();
 }
 
 void HTTPSEverywhereService::CloseDatabase() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  compiled_rules_cache_.Clear();
+  recently_used_cache_.clear();
+  recently_used_hosts_cache_.clear();
   if (level_db_) {
     delete level_db_;
     level_db_ = nullptr;
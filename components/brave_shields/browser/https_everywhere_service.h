@@ -10,12 +10,14 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
-#include "base/synchronization/lock.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
+#include "brave/components/brave_shields/browser/https_everywhere_redirect_counter.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rules.h"
 
 namespace leveldb {
 class DB;
@@ -31,18 +33,6 @@ extern const char kHTTPSEverywhereComponentName[];
 extern const char kHTTPSEverywhereComponentId[];
 extern const char kHTTPSEverywhereComponentBase64PublicKey[];
 
-struct HTTPSE_REDIRECTS_COUNT_ST {
- public:
-  HTTPSE_REDIRECTS_COUNT_ST(uint64_t request_identifier,
-                            unsigned int redirects):
-    request_identifier_(request_identifier),
-    redirects_(redirects) {
-  }
-
-  uint64_t request_identifier_;
-  unsigned int redirects_;
-};
-
 class HTTPSEverywhereService : public BaseBraveShieldsService,
                          public base::SupportsWeakPtr<HTTPSEverywhereService> {
  public:
@@ -54,6 +44,8 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
   bool GetHTTPSURLFromCacheOnly(const GURL* url,
                                 const uint64_t& request_id,
                                 std::string* cached_url);
+  // Forgets the redirect count of a request that went away.
+  void OnRequestDestroyed(uint64_t request_identifier);
 
  protected:
   bool Init() override;
@@ -64,9 +56,7 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
 
   void AddHTTPSEUrlToRedirectList(const uint64_t& request_id);
   bool ShouldHTTPSERedirect(const uint64_t& request_id);
-  std::string ApplyHTTPSRule(const std::string& originalUrl,
-      const std::string& rule);
-  std::string CorrecttoRuleToRE2Engine(const std::string& to);
+  const HTTPSERules* GetRulesForDomain(const std::string& domain);
 
  private:
   friend class ::HTTPSEverywhereServiceTest;
@@ -78,13 +68,23 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
       const std::string& component_id,
       const std::string& component_base64_public_key);
 
+  static GURL GetCandidateURL(const GURL& url);
+  bool GetHTTPSURLFromCache(const GURL& candidate_url, std::string* new_url);
+
   void CloseDatabase();
 
   void InitDB(const base::FilePath& install_dir);
 
-  base::Lock httpse_get_urls_redirects_count_mutex_;
-  std::vector<HTTPSE_REDIRECTS_COUNT_ST> httpse_urls_redirects_count_;
+  HTTPSERedirectCounter httpse_urls_redirects_count_;
+  // Upgraded URLs keyed by URL spec.
   HTTPSERecentlyUsedCache<std::string> recently_used_cache_;
+  // Hosts whose rules upgrade every URL, so the upgrade can be served for
+  // URLs that were never seen before.
+  HTTPSERecentlyUsedCache<bool> recently_used_hosts_cache_;
+  // Compiled rules keyed by leveldb lookup domain. A null entry records that
+  // the domain has no usable rules. Only used on the task runner.
+  base::MRUCache<std::string, std::unique_ptr<HTTPSERules>>
+      compiled_rules_cache_;
   leveldb::DB* level_db_;
 
   SEQUENCE_CHECKER(sequence_checker_);
@@ -0,0 +1,221 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/renderer_content_setting_rules_tracker.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/memory/ptr_util.h"
+#include "base/task/post_task.h"
+#include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "brave/content/common/frame_messages.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/common/renderer_configuration.mojom.h"
+#include "components/content_settings/core/common/content_settings_utils.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "components/content_settings/core/common/content_settings.h"
+#include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "ipc/ipc_channel_proxy.h"
+
+using content::BrowserThread;
+
+namespace brave_shields {
+
+namespace {
+
+const char kRendererContentSettingRulesTrackerKey[] =
+    "brave_renderer_content_setting_rules_tracker";
+
+// Whether a change of |content_type| can change RendererContentSettingRules.
+// Client hints are in the rules too, but they change with every Accept-CH
+// response; renderers pick them up with the next rules they are sent.
+bool IsRendererContentSetting(ContentSettingsType content_type,
+                              const std::string& resource_identifier) {
+  switch (content_type) {
+    // Sent when every type may have changed.
+    case CONTENT_SETTINGS_TYPE_DEFAULT:
+    case CONTENT_SETTINGS_TYPE_IMAGES:
+    case CONTENT_SETTINGS_TYPE_JAVASCRIPT:
+    case CONTENT_SETTINGS_TYPE_AUTOPLAY:
+    case CONTENT_SETTINGS_TYPE_POPUPS:
+      return true;
+    case CONTENT_SETTINGS_TYPE_PLUGINS:
+      return resource_identifier.empty() ||
+             resource_identifier == kFingerprinting ||
+             resource_identifier == kBraveShields;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+// static
+RendererContentSettingRulesTracker*
+RendererContentSettingRulesTracker::FromProfile(Profile* profile) {
+  auto* tracker = static_cast<RendererContentSettingRulesTracker*>(
+      profile->GetUserData(kRendererContentSettingRulesTrackerKey));
+  if (!tracker) {
+    tracker = new RendererContentSettingRulesTracker(profile);
+    profile->SetUserData(kRendererContentSettingRulesTrackerKey,
+                         base::WrapUnique(tracker));
+  }
+  return tracker;
+}
+
+RendererContentSettingRulesTracker::RendererContentSettingRulesTracker(
+    Profile* profile)
+    : profile_(profile),
+      content_settings_version_(0),
+      update_pending_(false),
+      content_settings_observer_(this),
+      render_process_observer_(this),
+      weak_factory_(this) {
+}
+
+RendererContentSettingRulesTracker::~RendererContentSettingRulesTracker() {
+}
+
+RendererContentSettingRulesTracker::ProcessState::ProcessState() {
+}
+
+RendererContentSettingRulesTracker::ProcessState::~ProcessState() {
+}
+
+void RendererContentSettingRulesTracker::AddFrame(
+    content::RenderProcessHost* process,
+    int render_frame_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (processes_.empty()) {
+    content_settings_observer_.Add(
+        HostContentSettingsMapFactory::GetForProfile(profile_));
+  }
+  if (!render_process_observer_.IsObserving(process)) {
+    render_process_observer_.Add(process);
+  }
+  processes_[process->GetID()].render_frame_ids.insert(render_frame_id);
+  SendRulesIfStale(process->GetID());
+}
+
+void RendererContentSettingRulesTracker::RemoveFrame(
+    content::RenderProcessHost* process,
+    int render_frame_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = processes_.find(process->GetID());
+  if (it == processes_.end()) {
+    return;
+  }
+  it->second.render_frame_ids.erase(render_frame_id);
+  if (it->second.render_frame_ids.empty()) {
+    RemoveProcess(process);
+  }
+}
+
+void RendererContentSettingRulesTracker::RenderProcessExited(
+    content::RenderProcessHost* host,
+    const content::ChildProcessTerminationInfo& info) {
+  // A relaunched process keeps its id but starts without any rules.
+  RemoveProcess(host);
+}
+
+void RendererContentSettingRulesTracker::RenderProcessHostDestroyed(
+    content::RenderProcessHost* host) {
+  RemoveProcess(host);
+}
+
+void RendererContentSettingRulesTracker::RemoveProcess(
+    content::RenderProcessHost* process) {
+  if (render_process_observer_.IsObserving(process)) {
+    render_process_observer_.Remove(process);
+  }
+  if (!processes_.erase(process->GetID()) || !processes_.empty()) {
+    return;
+  }
+  // Changes made while nothing is observed aren't seen, so the rules are
+  // built again for the next process.
+  content_settings_observer_.RemoveAll();
+  content_setting_rules_.reset();
+  content_settings_version_++;
+}
+
+int RendererContentSettingRulesTracker::GetSentVersionForTesting(
+    int render_process_id) const {
+  auto it = processes_.find(render_process_id);
+  return it == processes_.end() ? -1 : it->second.content_settings_version;
+}
+
+void RendererContentSettingRulesTracker::OnContentSettingChanged(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSettingsType content_type,
+    const std::string& resource_identifier) {
+  if (!IsRendererContentSetting(content_type, resource_identifier)) {
+    return;
+  }
+  content_settings_version_++;
+  content_setting_rules_.reset();
+  // Settings often change in bursts, e.g. when exceptions are imported or
+  // cleared, so the processes are updated once the burst is over.
+  if (update_pending_) {
+    return;
+  }
+  update_pending_ = true;
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::UI},
+      base::BindOnce(
+          &RendererContentSettingRulesTracker::SendRulesToAllProcesses,
+          weak_factory_.GetWeakPtr()));
+}
+
+const RendererContentSettingRules&
+RendererContentSettingRulesTracker::GetContentSettingRules() {
+  if (!content_setting_rules_) {
+    content_setting_rules_ = std::make_unique<RendererContentSettingRules>();
+    GetRendererContentSettingRules(
+        HostContentSettingsMapFactory::GetForProfile(profile_),
+        content_setting_rules_.get());
+  }
+  return *content_setting_rules_;
+}
+
+void RendererContentSettingRulesTracker::SendRulesIfStale(
+    int render_process_id) {
+  auto it = processes_.find(render_process_id);
+  if (it == processes_.end() ||
+      it->second.content_settings_version == content_settings_version_) {
+    return;
+  }
+  content::RenderProcessHost* process =
+      content::RenderProcessHost::FromID(render_process_id);
+  if (!process) {
+    return;
+  }
+  IPC::ChannelProxy* channel = process->GetChannel();
+  // channel might be NULL in tests.
+  if (channel) {
+    chrome::mojom::RendererConfigurationAssociatedPtr rc_interface;
+    channel->GetRemoteAssociatedInterface(&rc_interface);
+    rc_interface->SetContentSettingRules(GetContentSettingRules());
+    // Sent over the same channel, so the frames see the new rules by then.
+    for (int render_frame_id : it->second.render_frame_ids) {
+      process->Send(
+          new BraveFrameMsg_ContentSettingRulesChanged(render_frame_id));
+    }
+  }
+  it->second.content_settings_version = content_settings_version_;
+}
+
+void RendererContentSettingRulesTracker::SendRulesToAllProcesses() {
+  update_pending_ = false;
+  for (const auto& process : processes_) {
+    SendRulesIfStale(process.first);
+  }
+}
+
+}  // namespace brave_shields
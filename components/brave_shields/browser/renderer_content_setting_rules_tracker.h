@@ -0,0 +1,106 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_RENDERER_CONTENT_SETTING_RULES_TRACKER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_RENDERER_CONTENT_SETTING_RULES_TRACKER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/scoped_observer.h"
+#include "base/supports_user_data.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+class HostContentSettingsMap;
+class Profile;
+struct RendererContentSettingRules;
+
+namespace content {
+class RenderProcessHost;
+}
+
+namespace brave_shields {
+
+// Keeps the renderer processes of one profile up to date with the content
+// setting rules they apply. RendererContentSettingRules are process-wide, so
+// the rules are built once per change and sent once to each process, however
+// many tabs of the profile it hosts.
+class RendererContentSettingRulesTracker
+    : public base::SupportsUserData::Data,
+      public content_settings::Observer,
+      public content::RenderProcessHostObserver {
+ public:
+  // Creates the tracker of |profile| on first use.
+  static RendererContentSettingRulesTracker* FromProfile(Profile* profile);
+  ~RendererContentSettingRulesTracker() override;
+
+  // Called as frames of the profile's tabs come and go. A process is sent the
+  // rules with its first frame, and forgotten with its last one or when it
+  // exits, so that a relaunched process is sent them again. Adding or removing
+  // the same frame twice has no further effect.
+  void AddFrame(content::RenderProcessHost* process, int render_frame_id);
+  void RemoveFrame(content::RenderProcessHost* process, int render_frame_id);
+
+  int content_settings_version() const { return content_settings_version_; }
+  // Returns -1 if |render_process_id| wasn't sent any rules.
+  int GetSentVersionForTesting(int render_process_id) const;
+
+  // content_settings::Observer overrides.
+  void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
+                               const ContentSettingsPattern& secondary_pattern,
+                               ContentSettingsType content_type,
+                               const std::string& resource_identifier) override;
+
+  // content::RenderProcessHostObserver overrides.
+  void RenderProcessExited(
+      content::RenderProcessHost* host,
+      const content::ChildProcessTerminationInfo& info) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+ private:
+  explicit RendererContentSettingRulesTracker(Profile* profile);
+
+  struct ProcessState {
+    ProcessState();
+    ~ProcessState();
+
+    // Routing ids of the profile's frames in the process.
+    std::set<int> render_frame_ids;
+    // The |content_settings_version_| last sent to the process, if any.
+    int content_settings_version = -1;
+  };
+
+  // Returns the rules for |content_settings_version_|, computing them on
+  // first use.
+  const RendererContentSettingRules& GetContentSettingRules();
+  void RemoveProcess(content::RenderProcessHost* process);
+  void SendRulesIfStale(int render_process_id);
+  void SendRulesToAllProcesses();
+
+  Profile* profile_;
+  // Bumped whenever a setting in RendererContentSettingRules changes, so
+  // processes that were sent older rules can be told apart.
+  int content_settings_version_;
+  std::unique_ptr<RendererContentSettingRules> content_setting_rules_;
+  bool update_pending_;
+  std::map<int, ProcessState> processes_;
+  // Only observing while a process is tracked.
+  ScopedObserver<HostContentSettingsMap, content_settings::Observer>
+      content_settings_observer_;
+  ScopedObserver<content::RenderProcessHost, content::RenderProcessHostObserver>
+      render_process_observer_;
+  base::WeakPtrFactory<RendererContentSettingRulesTracker> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(RendererContentSettingRulesTracker);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_RENDERER_CONTENT_SETTING_RULES_TRACKER_H_
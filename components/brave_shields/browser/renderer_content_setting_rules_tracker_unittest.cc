@@ -0,0 +1,154 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/renderer_content_setting_rules_tracker.h"
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/run_loop.h"
+#include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/test/base/testing_profile.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "content/public/test/mock_render_process_host.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using brave_shields::RendererContentSettingRulesTracker;
+
+class RendererContentSettingRulesTrackerTest : public testing::Test {
+ public:
+  RendererContentSettingRulesTrackerTest() = default;
+  ~RendererContentSettingRulesTrackerTest() override = default;
+
+  void SetUp() override {
+    profile_ = std::make_unique<TestingProfile>();
+    process_ = std::make_unique<content::MockRenderProcessHost>(profile());
+    tracker_ = RendererContentSettingRulesTracker::FromProfile(profile());
+  }
+
+  void TearDown() override {
+    process_.reset();
+    profile_.reset();
+  }
+
+  TestingProfile* profile() { return profile_.get(); }
+  content::MockRenderProcessHost* process() { return process_.get(); }
+  int process_id() { return process_->GetID(); }
+  RendererContentSettingRulesTracker* tracker() { return tracker_; }
+  HostContentSettingsMap* map() {
+    return HostContentSettingsMapFactory::GetForProfile(profile());
+  }
+
+ private:
+  content::TestBrowserThreadBundle test_browser_thread_bundle_;
+  std::unique_ptr<TestingProfile> profile_;
+  std::unique_ptr<content::MockRenderProcessHost> process_;
+  RendererContentSettingRulesTracker* tracker_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(RendererContentSettingRulesTrackerTest);
+};
+
+TEST_F(RendererContentSettingRulesTrackerTest, SharedPerProfile) {
+  EXPECT_EQ(tracker(),
+            RendererContentSettingRulesTracker::FromProfile(profile()));
+
+  // Frames of two tabs in one process are only sent the rules once.
+  tracker()->AddFrame(process(), 1);
+  const int version = tracker()->content_settings_version();
+  EXPECT_EQ(version, tracker()->GetSentVersionForTesting(process_id()));
+  tracker()->AddFrame(process(), 2);
+  EXPECT_EQ(version, tracker()->content_settings_version());
+  EXPECT_EQ(version, tracker()->GetSentVersionForTesting(process_id()));
+
+  // The process is tracked until its last frame is gone.
+  tracker()->RemoveFrame(process(), 1);
+  EXPECT_EQ(version, tracker()->GetSentVersionForTesting(process_id()));
+  tracker()->RemoveFrame(process(), 2);
+  EXPECT_EQ(-1, tracker()->GetSentVersionForTesting(process_id()));
+}
+
+TEST_F(RendererContentSettingRulesTrackerTest, FrameSwap) {
+  // A swap reports the frames of both hosts, and may report them again.
+  tracker()->AddFrame(process(), 1);
+  const int version = tracker()->content_settings_version();
+  tracker()->AddFrame(process(), 2);
+  tracker()->AddFrame(process(), 2);
+  tracker()->RemoveFrame(process(), 1);
+  tracker()->RemoveFrame(process(), 1);
+  EXPECT_EQ(version, tracker()->GetSentVersionForTesting(process_id()));
+
+  // Frame 2 still lives in the process, so it keeps getting updates.
+  map()->SetContentSettingDefaultScope(
+      GURL("https://brave.com"), GURL(), CONTENT_SETTINGS_TYPE_JAVASCRIPT,
+      std::string(), CONTENT_SETTING_BLOCK);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(version + 1, tracker()->GetSentVersionForTesting(process_id()));
+
+  tracker()->RemoveFrame(process(), 2);
+  EXPECT_EQ(-1, tracker()->GetSentVersionForTesting(process_id()));
+}
+
+TEST_F(RendererContentSettingRulesTrackerTest, CrashAndRelaunch) {
+  tracker()->AddFrame(process(), 1);
+  tracker()->AddFrame(process(), 1);
+  EXPECT_EQ(tracker()->content_settings_version(),
+            tracker()->GetSentVersionForTesting(process_id()));
+
+  // The crashed process is forgotten even though its frame was never
+  // removed, so the relaunched one with the same id is sent the rules.
+  process()->SimulateCrash();
+  EXPECT_EQ(-1, tracker()->GetSentVersionForTesting(process_id()));
+
+  process()->Init();
+  tracker()->AddFrame(process(), 1);
+  EXPECT_EQ(tracker()->content_settings_version(),
+            tracker()->GetSentVersionForTesting(process_id()));
+}
+
+TEST_F(RendererContentSettingRulesTrackerTest, IgnoresUnrelatedSettings) {
+  const GURL url("https://brave.com");
+  tracker()->AddFrame(process(), 1);
+  const int version = tracker()->content_settings_version();
+
+  map()->SetContentSettingDefaultScope(
+      url, GURL(), CONTENT_SETTINGS_TYPE_GEOLOCATION, std::string(),
+      CONTENT_SETTING_BLOCK);
+  map()->SetContentSettingDefaultScope(
+      url, GURL(), CONTENT_SETTINGS_TYPE_NOTIFICATIONS, std::string(),
+      CONTENT_SETTING_BLOCK);
+  tracker()->OnContentSettingChanged(
+      ContentSettingsPattern::Wildcard(), ContentSettingsPattern::Wildcard(),
+      CONTENT_SETTINGS_TYPE_SITE_ENGAGEMENT, std::string());
+  tracker()->OnContentSettingChanged(
+      ContentSettingsPattern::Wildcard(), ContentSettingsPattern::Wildcard(),
+      CONTENT_SETTINGS_TYPE_CLIENT_HINTS, std::string());
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(version, tracker()->content_settings_version());
+  EXPECT_EQ(version, tracker()->GetSentVersionForTesting(process_id()));
+}
+
+TEST_F(RendererContentSettingRulesTrackerTest, SendsRuleChangesOnce) {
+  const GURL url("https://brave.com");
+  tracker()->AddFrame(process(), 1);
+  const int version = tracker()->content_settings_version();
+
+  map()->SetContentSettingDefaultScope(
+      url, GURL(), CONTENT_SETTINGS_TYPE_JAVASCRIPT, std::string(),
+      CONTENT_SETTING_BLOCK);
+  map()->SetContentSettingCustomScope(
+      ContentSettingsPattern::FromURL(url), ContentSettingsPattern::Wildcard(),
+      CONTENT_SETTINGS_TYPE_PLUGINS, brave_shields::kFingerprinting,
+      CONTENT_SETTING_BLOCK);
+  EXPECT_EQ(version + 2, tracker()->content_settings_version());
+  // The process is updated once the burst of changes is over.
+  EXPECT_EQ(version, tracker()->GetSentVersionForTesting(process_id()));
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(version + 2, tracker()->GetSentVersionForTesting(process_id()));
+}
@@ -10,8 +10,11 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
+#include "base/guid.h"
 #include "base/logging.h"
 #include "mojo/public/cpp/bindings/map.h"
+#include "net/base/escape.h"
 
 namespace bat_ledger {
 
@@ -100,12 +103,7 @@ BatLedgerClientMojoProxy::~BatLedgerClientMojoProxy() {
 }
 
 std::string BatLedgerClientMojoProxy::GenerateGUID() const {
-  if (!Connected())
-    return "";
-
-  std::string guid;
-  bat_ledger_client_->GenerateGUID(&guid);
-  return guid;
+  return base::GenerateGUID();
 }
 
 void OnLoadURL(const ledger::LoadURLCallback& callback,
@@ -381,23 +379,6 @@ void BatLedgerClientMojoProxy::LoadMediaPublisherInfo(
       base::BindOnce(&OnLoadMediaPublisherInfo, std::move(callback)));
 }
 
-void BatLedgerClientMojoProxy::SetTimer(uint64_t time_offset,
-    uint32_t* timer_id) {
-  if (!Connected()) {
-    return;
-  }
-
-  bat_ledger_client_->SetTimer(time_offset, timer_id);  // sync
-}
-
-void BatLedgerClientMojoProxy::KillTimer(const uint32_t timer_id) {
-  if (!Connected()) {
-    return;
-  }
-
-  bat_ledger_client_->KillTimer(timer_id);  // sync
-}
-
 void BatLedgerClientMojoProxy::OnPanelPublisherInfo(
     ledger::Result result,
     ledger::PublisherInfoPtr info,
@@ -539,12 +520,7 @@ void BatLedgerClientMojoProxy::SaveMediaPublisherInfo(
 }
 
 std::string BatLedgerClientMojoProxy::URIEncode(const std::string& value) {
-  if (!Connected())
-    return "";
-
-  std::string encoded_value;
-  bat_ledger_client_->URIEncode(value, &encoded_value);
-  return encoded_value;
+  return net::EscapeQueryParamValue(value, false);
 }
 
 void OnSavePendingContribution(
@@ -56,8 +56,6 @@ class BatLedgerClientMojoProxy : public ledger::LedgerClient,
                               ledger::PublisherInfoCallback callback) override;
   void SavePublishersList(const std::string& publishers_list,
                           ledger::LedgerCallbackHandler* handler) override;
-  void SetTimer(uint64_t time_offset, uint32_t* timer_id) override;
-  void KillTimer(const uint32_t timer_id) override;
   void LoadPublisherList(ledger::LedgerCallbackHandler* handler) override;
 
   void LoadURL(const std::string& url,
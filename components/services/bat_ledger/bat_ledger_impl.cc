@@ -140,6 +140,11 @@ void BatLedgerImpl::OnBackground(uint32_t tab_id, uint64_t current_time) {
   ledger_->OnBackground(tab_id, current_time);
 }
 
+void BatLedgerImpl::TakeVisitsForShutdown(
+    TakeVisitsForShutdownCallback callback) {
+  std::move(callback).Run(ledger_->TakeVisitsForShutdown());
+}
+
 void BatLedgerImpl::OnPostData(const std::string& url,
     const std::string& first_party_url, const std::string& referrer,
     const std::string& post_data, ledger::VisitDataPtr visit_data) {
@@ -305,10 +310,6 @@ void BatLedgerImpl::UpdateAdsRewards() {
   ledger_->UpdateAdsRewards();
 }
 
-void BatLedgerImpl::OnTimer(uint32_t timer_id) {
-  ledger_->OnTimer(timer_id);
-}
-
 void BatLedgerImpl::GetAllBalanceReports(
     GetAllBalanceReportsCallback callback) {
   std::map<std::string, ledger::BalanceReportInfoPtr> reports =
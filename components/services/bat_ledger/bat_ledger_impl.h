@@ -52,6 +52,7 @@ class BatLedgerImpl : public mojom::BatLedger,
   void OnHide(uint32_t tab_id, uint64_t current_time) override;
   void OnForeground(uint32_t tab_id, uint64_t current_time) override;
   void OnBackground(uint32_t tab_id, uint64_t current_time) override;
+  void TakeVisitsForShutdown(TakeVisitsForShutdownCallback callback) override;
 
   void OnPostData(const std::string& url,
       const std::string& first_party_url, const std::string& referrer,
@@ -96,8 +97,6 @@ class BatLedgerImpl : public mojom::BatLedger,
   void SetAutoContribute(bool enabled) override;
   void UpdateAdsRewards() override;
 
-  void OnTimer(uint32_t timer_id) override;
-
   void GetAllBalanceReports(GetAllBalanceReportsCallback callback) override;
   void GetBalanceReport(int32_t month, int32_t year,
       GetBalanceReportCallback callback) override;
@@ -67,10 +67,6 @@ void LedgerClientMojoProxy::LoadLedgerState(LoadLedgerStateCallback callback) {
       std::bind(LedgerClientMojoProxy::OnLoadLedgerState, holder, _1, _2));
 }
 
-void LedgerClientMojoProxy::GenerateGUID(GenerateGUIDCallback callback) {
-  std::move(callback).Run(ledger_client_->GenerateGUID());
-}
-
 void LedgerClientMojoProxy::OnWalletInitialized(const ledger::Result result) {
   ledger_client_->OnWalletInitialized(result);
 }
@@ -320,17 +316,6 @@ void LedgerClientMojoProxy::LoadMediaPublisherInfo(
                 holder, _1, _2));
 }
 
-void LedgerClientMojoProxy::SetTimer(uint64_t time_offset,
-    SetTimerCallback callback) {
-  uint32_t timer_id;
-  ledger_client_->SetTimer(time_offset, &timer_id);
-  std::move(callback).Run(timer_id);
-}
-
-void LedgerClientMojoProxy::KillTimer(const uint32_t timer_id) {
-  ledger_client_->KillTimer(timer_id);
-}
-
 void LedgerClientMojoProxy::OnPanelPublisherInfo(
     const ledger::Result result,
     ledger::PublisherInfoPtr publisher_info,
@@ -457,11 +442,6 @@ void LedgerClientMojoProxy::SaveMediaPublisherInfo(
   ledger_client_->SaveMediaPublisherInfo(media_key, publisher_id);
 }
 
-void LedgerClientMojoProxy::URIEncode(const std::string& value,
-    URIEncodeCallback callback) {
-  std::move(callback).Run(ledger_client_->URIEncode(value));
-}
-
 // static
 void LedgerClientMojoProxy::OnLoadURL(
     CallbackHolder<LoadURLCallback>* holder,
@@ -25,7 +25,6 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
   ~LedgerClientMojoProxy() override;
 
   // bat_ledger::mojom::BatLedgerClient
-  void GenerateGUID(GenerateGUIDCallback callback) override;
   void LoadLedgerState(LoadLedgerStateCallback callback) override;
   void OnWalletInitialized(const ledger::Result result) override;
   void OnWalletProperties(
@@ -76,8 +75,6 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
     const std::string& publisher_key,
     RemoveRecurringTipCallback callback) override;
 
-  void SetTimer(uint64_t time_offset, SetTimerCallback callback) override;
-  void KillTimer(const uint32_t timer_id) override;
   void OnPanelPublisherInfo(
       const ledger::Result result,
       ledger::PublisherInfoPtr info,
@@ -88,9 +85,6 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
   void SaveMediaPublisherInfo(const std::string& media_key,
       const std::string& publisher_id) override;
 
-  void URIEncode(const std::string& value,
-      URIEncodeCallback callback) override;
-
   void LoadURL(const std::string& url,
     const std::vector<std::string>& headers,
     const std::string& content,
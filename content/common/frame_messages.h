@@ -19,3 +19,7 @@
 IPC_MESSAGE_ROUTED1(
     BraveFrameMsg_AllowScriptsOnce,
     std::vector<std::string> /* origins to allow scripts once */)
+
+// Tell a RenderFrame that its process was just sent new content setting
+// rules, so decisions it made from the old ones are stale.
+IPC_MESSAGE_ROUTED0(BraveFrameMsg_ContentSettingRulesChanged)
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/bind_helpers.h"
+#include "base/no_destructor.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/render_messages.h"
 #include "brave/common/shield_exceptions.h"
@@ -25,11 +26,25 @@
 #include "third_party/blink/public/web/web_local_frame.h"
 #include "url/url_constants.h"
 
+#define DECISION_CACHE_SIZE 64
+
+namespace {
+
+const ContentSettingsPattern& FirstPartyPattern() {
+  static const base::NoDestructor<ContentSettingsPattern> first_party(
+      ContentSettingsPattern::FromString("https://firstParty/*"));
+  return *first_party;
+}
+
+}  // namespace
+
 BraveContentSettingsObserver::BraveContentSettingsObserver(
     content::RenderFrame* render_frame,
     bool should_whitelist,
     service_manager::BinderRegistry* registry)
-    : ContentSettingsObserver(render_frame, should_whitelist, registry) {
+    : ContentSettingsObserver(render_frame, should_whitelist, registry),
+      shields_down_decisions_(DECISION_CACHE_SIZE),
+      fingerprinting_decisions_(DECISION_CACHE_SIZE) {
 }
 
 BraveContentSettingsObserver::~BraveContentSettingsObserver() {
@@ -40,6 +55,8 @@ bool BraveContentSettingsObserver::OnMessageReceived(
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(BraveContentSettingsObserver, message)
     IPC_MESSAGE_HANDLER(BraveFrameMsg_AllowScriptsOnce, OnAllowScriptsOnce)
+    IPC_MESSAGE_HANDLER(BraveFrameMsg_ContentSettingRulesChanged,
+                        OnContentSettingRulesChanged)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -52,11 +69,16 @@ void BraveContentSettingsObserver::OnAllowScriptsOnce(
   preloaded_temporarily_allowed_scripts_ = std::move(origins);
 }
 
+void BraveContentSettingsObserver::OnContentSettingRulesChanged() {
+  ClearDecisionCaches();
+}
+
 void BraveContentSettingsObserver::DidCommitProvisionalLoad(
     bool is_same_document_navigation, ui::PageTransition transition) {
   if (!is_same_document_navigation) {
     temporarily_allowed_scripts_ =
       std::move(preloaded_temporarily_allowed_scripts_);
+    ClearDecisionCaches();
   }
 
   ContentSettingsObserver::DidCommitProvisionalLoad(
@@ -146,23 +168,36 @@ GURL BraveContentSettingsObserver::GetOriginOrURL(
   return top_origin.GetURL();
 }
 
+// static
+bool BraveContentSettingsObserver::GetDecisionCacheKey(
+    const GURL& primary_url,
+    const GURL& secondary_url,
+    std::pair<GURL, GURL>* key) {
+  // Patterns only match the path of file: URLs, so for http(s) the origin
+  // decides as well as the whole URL does.
+  if (!secondary_url.SchemeIsHTTPOrHTTPS())
+    return false;
+  *key = std::make_pair(primary_url, secondary_url.GetOrigin());
+  return true;
+}
+
+void BraveContentSettingsObserver::ClearDecisionCaches() {
+  shields_down_decisions_.Clear();
+  fingerprinting_decisions_.Clear();
+}
+
 ContentSetting BraveContentSettingsObserver::GetFPContentSettingFromRules(
     const ContentSettingsForOneType& rules,
-    const blink::WebFrame* frame,
+    const GURL& primary_url,
     const GURL& secondary_url) {
-
-  if (rules.size() == 0)
-    return CONTENT_SETTING_DEFAULT;
-
-  const GURL& primary_url = GetOriginOrURL(frame);
+  const ContentSettingsPattern first_party_pattern =
+      ContentSettingsPattern::FromString("[*.]" +
+                                         primary_url.HostNoBrackets());
 
   for (const auto& rule : rules) {
-    ContentSettingsPattern secondary_pattern = rule.secondary_pattern;
-    if (rule.secondary_pattern ==
-        ContentSettingsPattern::FromString("https://firstParty/*")) {
-      secondary_pattern = ContentSettingsPattern::FromString(
-          "[*.]" + GetOriginOrURL(frame).HostNoBrackets());
-    }
+    const ContentSettingsPattern& secondary_pattern =
+        rule.secondary_pattern == FirstPartyPattern() ? first_party_pattern
+                                                      : rule.secondary_pattern;
 
     if (rule.primary_pattern.Matches(primary_url) &&
         (secondary_pattern == ContentSettingsPattern::Wildcard() ||
@@ -171,6 +206,10 @@ ContentSetting BraveContentSettingsObserver::GetFPContentSettingFromRules(
     }
   }
 
+  // First party resources that don't match any rule are allowed by default.
+  if (first_party_pattern.Matches(secondary_url))
+    return CONTENT_SETTING_ALLOW;
+
   // for cases which are third party resources and doesn't match any existing
   // rules, block them by default
   return CONTENT_SETTING_BLOCK;
@@ -179,9 +218,17 @@ ContentSetting BraveContentSettingsObserver::GetFPContentSettingFromRules(
 bool BraveContentSettingsObserver::IsBraveShieldsDown(
     const blink::WebFrame* frame,
     const GURL& secondary_url) {
-  ContentSetting setting = CONTENT_SETTING_DEFAULT;
   const GURL& primary_url = GetOriginOrURL(frame);
 
+  std::pair<GURL, GURL> key;
+  const bool cacheable = GetDecisionCacheKey(primary_url, secondary_url, &key);
+  if (cacheable) {
+    auto it = shields_down_decisions_.Get(key);
+    if (it != shields_down_decisions_.end())
+      return it->second;
+  }
+
+  ContentSetting setting = CONTENT_SETTING_DEFAULT;
   if (content_setting_rules_) {
     for (const auto& rule : content_setting_rules_->brave_shields_rules) {
       if (rule.primary_pattern.Matches(primary_url) &&
@@ -192,7 +239,10 @@ bool BraveContentSettingsObserver::IsBraveShieldsDown(
     }
   }
 
-  return setting == CONTENT_SETTING_BLOCK;
+  const bool shields_down = setting == CONTENT_SETTING_BLOCK;
+  if (cacheable)
+    shields_down_decisions_.Put(key, shields_down);
+  return shields_down;
 }
 
 bool BraveContentSettingsObserver::AllowFingerprinting(
@@ -202,28 +252,32 @@ bool BraveContentSettingsObserver::AllowFingerprinting(
   blink::WebLocalFrame* frame = render_frame()->GetWebFrame();
   const GURL secondary_url(
       url::Origin(frame->GetDocument().GetSecurityOrigin()).GetURL());
-  if (IsBraveShieldsDown(frame, secondary_url)) {
-    return true;
-  }
   const GURL& primary_url = GetOriginOrURL(frame);
-  if (brave::IsWhitelistedFingerprintingException(primary_url, secondary_url)) {
-    return true;
-  }
-  ContentSettingsForOneType rules;
-  if (content_setting_rules_) {
-      rules = content_setting_rules_->fingerprinting_rules;
+
+  std::pair<GURL, GURL> key;
+  const bool cacheable = GetDecisionCacheKey(primary_url, secondary_url, &key);
+  auto it = cacheable ? fingerprinting_decisions_.Get(key)
+                      : fingerprinting_decisions_.end();
+  bool allow;
+  if (it != fingerprinting_decisions_.end()) {
+    allow = it->second;
+  } else {
+    if (IsBraveShieldsDown(frame, secondary_url) ||
+        brave::IsWhitelistedFingerprintingException(primary_url,
+                                                    secondary_url)) {
+      allow = true;
+    } else {
+      static const base::NoDestructor<ContentSettingsForOneType> no_rules;
+      const ContentSettingsForOneType& rules =
+          content_setting_rules_ ? content_setting_rules_->fingerprinting_rules
+                                 : *no_rules;
+      const ContentSetting setting =
+          GetFPContentSettingFromRules(rules, primary_url, secondary_url);
+      allow = setting != CONTENT_SETTING_BLOCK;
+    }
+    if (cacheable)
+      fingerprinting_decisions_.Put(key, allow);
   }
-  ContentSettingPatternSource default_rule = ContentSettingPatternSource(
-      ContentSettingsPattern::Wildcard(),
-      ContentSettingsPattern::FromString("https://firstParty/*"),
-      base::Value::FromUniquePtrValue(
-          content_settings::ContentSettingToValue(CONTENT_SETTING_ALLOW)),
-      std::string(), false);
-  rules.push_back(default_rule);
-  ContentSetting setting =
-      GetFPContentSettingFromRules(rules, frame, secondary_url);
-  rules.pop_back();
-  bool allow = setting != CONTENT_SETTING_BLOCK;
   allow = allow || IsWhitelistedForContentSettings();
 
   if (!allow) {
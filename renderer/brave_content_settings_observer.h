@@ -5,10 +5,16 @@
 #ifndef BRAVE_RENDERER_CONTENT_SETTINGS_OBSERVER_H_
 #define BRAVE_RENDERER_CONTENT_SETTINGS_OBSERVER_H_
 
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
 #include "base/strings/string16.h"
 #include "chrome/renderer/content_settings_observer.h"
 #include "components/content_settings/core/common/content_settings.h"
 #include "components/content_settings/core/common/content_settings_types.h"
+#include "url/gurl.h"
 
 namespace blink {
 class WebLocalFrame;
@@ -44,16 +50,24 @@ class BraveContentSettingsObserver
 
   ContentSetting GetFPContentSettingFromRules(
       const ContentSettingsForOneType& rules,
-      const blink::WebFrame* frame,
+      const GURL& primary_url,
       const GURL& secondary_url);
 
   bool IsBraveShieldsDown(
       const blink::WebFrame* frame,
       const GURL& secondary_url);
 
+  // Returns the key of a (primary url, secondary url) decision, or false if
+  // the decision shouldn't be cached.
+  static bool GetDecisionCacheKey(const GURL& primary_url,
+                                  const GURL& secondary_url,
+                                  std::pair<GURL, GURL>* key);
+  void ClearDecisionCaches();
+
   // RenderFrameObserver
   bool OnMessageReceived(const IPC::Message& message) override;
   void OnAllowScriptsOnce(const std::vector<std::string>& origins);
+  void OnContentSettingRulesChanged();
   void DidCommitProvisionalLoad(bool is_same_document_navigation,
                                 ui::PageTransition transition) override;
 
@@ -69,6 +83,12 @@ class BraveContentSettingsObserver
   // temporary allowed script origins we preloaded for the next load
   base::flat_set<std::string> preloaded_temporarily_allowed_scripts_;
 
+  // Fingerprinting APIs and scripts ask for the same decisions over and over,
+  // so they are kept per (primary url, secondary origin) until the document
+  // or the rules change.
+  base::MRUCache<std::pair<GURL, GURL>, bool> shields_down_decisions_;
+  base::MRUCache<std::pair<GURL, GURL>, bool> fingerprinting_decisions_;
+
   DISALLOW_COPY_AND_ASSIGN(BraveContentSettingsObserver);
 };
 
@@ -13,6 +13,7 @@
 #include "chrome/test/base/in_process_browser_test.h"
 #include "chrome/test/base/ui_test_utils.h"
 #include "content/public/test/browser_test_utils.h"
+#include "content/public/test/test_utils.h"
 #include "content/public/browser/render_frame_host.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
 #include "components/content_settings/core/common/content_settings.h"
@@ -402,6 +403,30 @@ IN_PROC_BROWSER_TEST_F(BraveContentSettingsObserverBrowserTest, AllowFP) {
   EXPECT_TRUE(isPointInPath);
 }
 
+IN_PROC_BROWSER_TEST_F(BraveContentSettingsObserverBrowserTest,
+                       ChangeFPWithoutReload) {
+  BlockFingerprinting();
+  NavigateToPageWithIframe();
+
+  bool isPointInPath;
+  EXPECT_TRUE(ExecuteScriptAndExtractBool(contents(),
+      kPointInPathScript, &isPointInPath));
+  EXPECT_FALSE(isPointInPath);
+
+  // Same rules with new values, so the page's cached decision must go.
+  AllowFingerprinting();
+  ContentSettingsForOneType fp_settings;
+  content_settings()->GetSettingsForOneType(
+      CONTENT_SETTINGS_TYPE_PLUGINS, brave_shields::kFingerprinting,
+      &fp_settings);
+  EXPECT_EQ(fp_settings.size(), 2u);
+  content::RunAllPendingInMessageLoop();
+
+  EXPECT_TRUE(ExecuteScriptAndExtractBool(contents(),
+      kPointInPathScript, &isPointInPath));
+  EXPECT_TRUE(isPointInPath);
+}
+
 IN_PROC_BROWSER_TEST_F(BraveContentSettingsObserverBrowserTest,
     BlockThirdPartyFP) {
   Block3PFingerprinting();